@@ -27,6 +27,20 @@ CHECK (VALUE IN ('I', 'U', 'D'));
 COMMENT ON DOMAIN FTS$D_CHANGE_TYPE IS
 'Type of record change. I - INSERT, U - UPDATE, D - DELETE.';
 
+CREATE DOMAIN FTS$D_KEY_ENCODING
+VARCHAR(10) CHARACTER SET UTF8
+CHECK (VALUE IN ('TEXT', 'BINARY'));
+
+COMMENT ON DOMAIN FTS$D_KEY_ENCODING IS
+'Format of the key values in the full-text index. TEXT - hex or decimal string, BINARY - raw bytes or trie-encoded number.';
+
+CREATE DOMAIN FTS$D_STORAGE
+VARCHAR(10) CHARACTER SET UTF8
+CHECK (VALUE IN ('FS', 'MMAP', 'RAM'));
+
+COMMENT ON DOMAIN FTS$D_STORAGE IS
+'Storage of the full-text index. FS - files read through buffers, MMAP - memory-mapped files, RAM - in-memory copy of the files for searching.';
+
 
 CREATE TABLE FTS$INDICES(
    FTS$INDEX_NAME   VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
@@ -34,6 +48,10 @@ CREATE TABLE FTS$INDICES(
    FTS$ANALYZER     VARCHAR(63) CHARACTER SET UTF8 DEFAULT 'STANDARD' NOT NULL,
    FTS$DESCRIPTION  BLOB SUB_TYPE TEXT CHARACTER SET UTF8,
    FTS$INDEX_STATUS FTS$D_INDEX_STATUS DEFAULT 'N' NOT NULL,
+   FTS$KEY_ENCODING FTS$D_KEY_ENCODING DEFAULT 'BINARY' NOT NULL,
+   FTS$PARALLELISM  SMALLINT DEFAULT 1 NOT NULL,
+   FTS$STORAGE      FTS$D_STORAGE DEFAULT 'FS' NOT NULL,
+   FTS$MERGE_FACTOR SMALLINT DEFAULT 10 NOT NULL,
    CONSTRAINT PK_FTS$INDEX_NAME PRIMARY KEY(FTS$INDEX_NAME)
 );
 
@@ -61,11 +79,24 @@ COMMENT ON COLUMN FTS$INDICES.FTS$DESCRIPTION IS
 COMMENT ON COLUMN FTS$INDICES.FTS$INDEX_STATUS IS
 'Full-text index status.';
 
+COMMENT ON COLUMN FTS$INDICES.FTS$KEY_ENCODING IS
+'Format of the key values. Applied when the index is built or rebuilt.';
+
+COMMENT ON COLUMN FTS$INDICES.FTS$PARALLELISM IS
+'Max number of threads searching the index segments in parallel. 1 - the search runs on one thread.';
+
+COMMENT ON COLUMN FTS$INDICES.FTS$STORAGE IS
+'Storage used to read the index. Does not require the index to be rebuilt.';
+
+COMMENT ON COLUMN FTS$INDICES.FTS$MERGE_FACTOR IS
+'Number of segments of similar size merged into one segment when the index is updated. Does not require the index to be rebuilt.';
+
 CREATE TABLE FTS$INDEX_SEGMENTS(
    FTS$INDEX_NAME    VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
    FTS$FIELD_NAME    VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
    FTS$BOOST         DOUBLE PRECISION,
    FTS$KEY           BOOLEAN DEFAULT FALSE NOT NULL,
+   FTS$SORTABLE      BOOLEAN DEFAULT FALSE NOT NULL,
    CONSTRAINT UK_FTS$INDEX_SEGMENTS UNIQUE(FTS$INDEX_NAME, FTS$FIELD_NAME),
    CONSTRAINT FK_FTS$INDEX_SEGMENTS FOREIGN KEY(FTS$INDEX_NAME) REFERENCES FTS$INDICES(FTS$INDEX_NAME) ON DELETE CASCADE
 );
@@ -86,10 +117,14 @@ COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$BOOST IS
 COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$KEY IS 
 'Is the field a key';
 
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$SORTABLE IS 
+'Can the search results be sorted by the field';
+
 CREATE TABLE FTS$ANALYZERS (
     FTS$ANALYZER_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
     FTS$BASE_ANALYZER VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
     FTS$DESCRIPTION   BLOB SUB_TYPE TEXT CHARACTER SET UTF8,
+    FTS$STOP_WORDS_VERSION BIGINT DEFAULT 0 NOT NULL,
     CONSTRAINT PK_FTS$ANALYZER PRIMARY KEY(FTS$ANALYZER_NAME)
 );
 
@@ -105,6 +140,14 @@ COMMENT ON COLUMN FTS$ANALYZERS.FTS$ANALYZER_NAME IS
 COMMENT ON COLUMN FTS$ANALYZERS.FTS$ANALYZER_NAME IS 
 'Description of analyzer';
 
+COMMENT ON COLUMN FTS$ANALYZERS.FTS$STOP_WORDS_VERSION IS 
+'Version of the stop words list. Changes every time a stop word is added or deleted';
+
+CREATE SEQUENCE FTS$STOP_WORDS_VERSION;
+
+COMMENT ON SEQUENCE FTS$STOP_WORDS_VERSION IS 
+'Source of versions for stop words lists of custom analyzers';
+
 CREATE TABLE FTS$STOP_WORDS (
     FTS$ANALYZER_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
     FTS$WORD VARCHAR(63) CHARACTER SET UTF8 NOT NULL COLLATE UNICODE_CI,
@@ -156,6 +199,26 @@ COMMENT ON COLUMN FTS$LOG.FTS$REC_ID IS
 COMMENT ON COLUMN FTS$LOG.FTS$CHANGE_TYPE IS
 'Type of record change.';
 
+CREATE TABLE FTS$WARMUP_QUERIES (
+  FTS$QUERY_ID            INTEGER GENERATED BY DEFAULT AS IDENTITY,
+  FTS$INDEX_NAME          VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+  FTS$QUERY               VARCHAR(8191) CHARACTER SET UTF8 NOT NULL,
+  CONSTRAINT PK_FTS$WARMUP_QUERIES PRIMARY KEY(FTS$QUERY_ID),
+  CONSTRAINT FK_FTS$WARMUP_QUERIES FOREIGN KEY(FTS$INDEX_NAME) REFERENCES FTS$INDICES(FTS$INDEX_NAME) ON DELETE CASCADE
+);
+
+COMMENT ON TABLE FTS$WARMUP_QUERIES IS
+'Queries run by FTS$WARMUP_INDEX and FTS$WARMUP_ALL to warm up full-text indexes.';
+
+COMMENT ON COLUMN FTS$WARMUP_QUERIES.FTS$QUERY_ID IS
+'Identifier. Queries run in the order of identifiers.';
+
+COMMENT ON COLUMN FTS$WARMUP_QUERIES.FTS$INDEX_NAME IS
+'Full-text index name.';
+
+COMMENT ON COLUMN FTS$WARMUP_QUERIES.FTS$QUERY IS
+'Full text search expression.';
+
 SET TERM ^ ;
 
 CREATE OR ALTER PACKAGE FTS$MANAGEMENT
@@ -169,6 +232,12 @@ BEGIN
   RETURNS VARCHAR(255) CHARACTER SET UTF8
   DETERMINISTIC;
 
+  /**
+   * Forces the settings files fts.ini and fts.conf to be read again.
+   * Without calling it, changes in these files are picked up within 10 seconds.
+  **/
+  PROCEDURE FTS$RELOAD_CONFIG;
+
   /**
    * Returns a list of system analyzers.
    *
@@ -356,6 +425,66 @@ BEGIN
       FTS$DESCRIPTION BLOB SUB_TYPE TEXT CHARACTER SET UTF8
   );
 
+  /**
+   * Sets the format of the key values in the full-text index.
+   *
+   * The index keeps its current format until it is rebuilt.
+   *
+   * Input parameters:
+   *   FTS$INDEX_NAME - name of the index;
+   *   FTS$KEY_ENCODING - key format (TEXT or BINARY).
+  **/
+  PROCEDURE FTS$SET_INDEX_KEY_ENCODING (
+      FTS$INDEX_NAME   VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$KEY_ENCODING VARCHAR(10) CHARACTER SET UTF8 NOT NULL
+  );
+
+  /**
+   * Sets the max number of threads searching the index segments in parallel.
+   *
+   * The setting does not require the index to be rebuilt.
+   *
+   * Input parameters:
+   *   FTS$INDEX_NAME - name of the index;
+   *   FTS$PARALLELISM - max number of threads (1 - the search runs on one thread).
+  **/
+  PROCEDURE FTS$SET_INDEX_PARALLELISM (
+      FTS$INDEX_NAME  VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$PARALLELISM SMALLINT NOT NULL
+  );
+
+  /**
+   * Sets the storage the index is read from.
+   *
+   * FS - files read through buffers, MMAP - memory-mapped files,
+   * RAM - the files are copied into memory for searching, the index is updated on the disk.
+   * The setting does not require the index to be rebuilt.
+   *
+   * Input parameters:
+   *   FTS$INDEX_NAME - name of the index;
+   *   FTS$STORAGE - storage of the index (FS, MMAP or RAM).
+  **/
+  PROCEDURE FTS$SET_INDEX_STORAGE (
+      FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$STORAGE    VARCHAR(10) CHARACTER SET UTF8 NOT NULL
+  );
+
+  /**
+   * Sets the number of segments of similar size merged into one segment when the index is updated.
+   *
+   * Smaller values keep fewer segments and speed up searches, larger values speed up updates.
+   * The whole index is merged into one segment only by FTS$OPTIMIZE_INDEX.
+   * The setting does not require the index to be rebuilt.
+   *
+   * Input parameters:
+   *   FTS$INDEX_NAME - name of the index;
+   *   FTS$MERGE_FACTOR - number of merged segments (at least 2).
+  **/
+  PROCEDURE FTS$SET_INDEX_MERGE_FACTOR (
+      FTS$INDEX_NAME   VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$MERGE_FACTOR SMALLINT NOT NULL
+  );
+
   /**
    * Add a new segment (indexed table field) of the full-text index.
    *
@@ -396,6 +525,20 @@ BEGIN
       FTS$BOOST DOUBLE PRECISION
   );
 
+  /**
+   * Sets whether the search results can be sorted by the full-text index field.
+   *
+   * Input parameters:
+   *   FTS$INDEX_NAME - name of the index;
+   *   FTS$FIELD_NAME - name of the field;
+   *   FTS$SORTABLE - sortable flag.
+  **/
+  PROCEDURE FTS$SET_INDEX_FIELD_SORTABLE (
+      FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+      FTS$SORTABLE BOOLEAN NOT NULL
+  );
+
   /**
    * Rebuild the full-text index.
    *
@@ -446,6 +589,10 @@ BEGIN
   EXTERNAL NAME 'luceneudr!getFTSDirectory' ENGINE UDR;
 
 
+  PROCEDURE FTS$RELOAD_CONFIG
+  EXTERNAL NAME 'luceneudr!reloadConfig' ENGINE UDR;
+
+
   PROCEDURE FTS$SYSTEM_ANALYZERS
   RETURNS (
     FTS$ANALYZER VARCHAR(63) CHARACTER SET UTF8,
@@ -636,6 +783,11 @@ BEGIN
         EXCEPTION FTS$EXCEPTION 'Stop word "' || FTS$WORD || '" already exists for analyzer "' || FTS$ANALYZER_NAME || '"';
     END
 
+    -- The new version of stop words invalidates cached analyzers.
+    UPDATE FTS$ANALYZERS
+    SET FTS$STOP_WORDS_VERSION = NEXT VALUE FOR FTS$STOP_WORDS_VERSION
+    WHERE FTS$ANALYZER_NAME = :FTS$ANALYZER_NAME;
+
     -- Setting the flag that the index needs to be updated.
     UPDATE FTS$INDICES
     SET FTS$INDEX_STATUS = 'U'
@@ -654,6 +806,11 @@ BEGIN
 
     IF (ROW_COUNT > 0) THEN
     BEGIN
+      -- The new version of stop words invalidates cached analyzers.
+      UPDATE FTS$ANALYZERS
+      SET FTS$STOP_WORDS_VERSION = NEXT VALUE FOR FTS$STOP_WORDS_VERSION
+      WHERE FTS$ANALYZER_NAME = :FTS$ANALYZER_NAME;
+
       -- Setting the flag that the index needs to be updated.
       UPDATE FTS$INDICES
       SET FTS$INDEX_STATUS = 'U'
@@ -696,6 +853,63 @@ BEGIN
   END
 
 
+  PROCEDURE FTS$SET_INDEX_KEY_ENCODING (
+    FTS$INDEX_NAME   VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$KEY_ENCODING VARCHAR(10) CHARACTER SET UTF8 NOT NULL
+  )
+  AS
+  BEGIN
+    -- Setting the flag that the index needs to be rebuilt to apply the new format.
+    UPDATE FTS$INDICES
+    SET FTS$KEY_ENCODING = UPPER(:FTS$KEY_ENCODING),
+        FTS$INDEX_STATUS = IIF(FTS$INDEX_STATUS = 'C', 'U', FTS$INDEX_STATUS)
+    WHERE FTS$INDEX_NAME = :FTS$INDEX_NAME
+      AND FTS$KEY_ENCODING <> UPPER(:FTS$KEY_ENCODING);
+  END
+
+
+  PROCEDURE FTS$SET_INDEX_PARALLELISM (
+    FTS$INDEX_NAME  VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$PARALLELISM SMALLINT NOT NULL
+  )
+  AS
+  BEGIN
+    IF (FTS$PARALLELISM < 1) THEN
+      EXCEPTION FTS$EXCEPTION 'Parallelism must be greater than 0';
+
+    UPDATE FTS$INDICES
+    SET FTS$PARALLELISM = :FTS$PARALLELISM
+    WHERE FTS$INDEX_NAME = :FTS$INDEX_NAME;
+  END
+
+
+  PROCEDURE FTS$SET_INDEX_STORAGE (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$STORAGE    VARCHAR(10) CHARACTER SET UTF8 NOT NULL
+  )
+  AS
+  BEGIN
+    UPDATE FTS$INDICES
+    SET FTS$STORAGE = UPPER(:FTS$STORAGE)
+    WHERE FTS$INDEX_NAME = :FTS$INDEX_NAME;
+  END
+
+
+  PROCEDURE FTS$SET_INDEX_MERGE_FACTOR (
+    FTS$INDEX_NAME   VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$MERGE_FACTOR SMALLINT NOT NULL
+  )
+  AS
+  BEGIN
+    IF (FTS$MERGE_FACTOR < 2) THEN
+      EXCEPTION FTS$EXCEPTION 'Merge factor must be greater than 1';
+
+    UPDATE FTS$INDICES
+    SET FTS$MERGE_FACTOR = :FTS$MERGE_FACTOR
+    WHERE FTS$INDEX_NAME = :FTS$INDEX_NAME;
+  END
+
+
   PROCEDURE FTS$ADD_INDEX_FIELD (
     FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
     FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
@@ -719,6 +933,14 @@ BEGIN
   EXTERNAL NAME 'luceneudr!setIndexFieldBoost' ENGINE UDR;
 
 
+  PROCEDURE FTS$SET_INDEX_FIELD_SORTABLE (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$SORTABLE BOOLEAN NOT NULL
+  )
+  EXTERNAL NAME 'luceneudr!setIndexFieldSortable' ENGINE UDR;
+
+
   PROCEDURE FTS$REBUILD_INDEX (
     FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL
   )
@@ -775,7 +997,8 @@ SET TERM ; ^
 COMMENT ON PACKAGE FTS$MANAGEMENT IS
 'Procedures and functions for managing full-text indexes.';
 
-GRANT SELECT,INSERT,DELETE ON FTS$ANALYZERS TO PACKAGE FTS$MANAGEMENT;
+GRANT SELECT,INSERT,UPDATE,DELETE ON FTS$ANALYZERS TO PACKAGE FTS$MANAGEMENT;
+GRANT USAGE ON SEQUENCE FTS$STOP_WORDS_VERSION TO PACKAGE FTS$MANAGEMENT;
 GRANT USAGE ON EXCEPTION FTS$EXCEPTION TO PACKAGE FTS$MANAGEMENT;
 GRANT ALL ON TABLE FTS$INDICES TO PACKAGE FTS$MANAGEMENT;
 GRANT ALL ON TABLE FTS$INDEX_SEGMENTS TO PACKAGE FTS$MANAGEMENT;
@@ -797,7 +1020,16 @@ CREATE OR ALTER PROCEDURE FTS$SEARCH (
     FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
     FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
     FTS$LIMIT INT NOT NULL DEFAULT 1000,
-    FTS$EXPLAIN BOOLEAN DEFAULT FALSE
+    FTS$EXPLAIN BOOLEAN DEFAULT FALSE,
+    FTS$OFFSET INT NOT NULL DEFAULT 0,
+    FTS$AFTER_SCORE DOUBLE PRECISION DEFAULT NULL,
+    FTS$AFTER_DOC_ID INT DEFAULT NULL,
+    FTS$TIMEOUT_MS INT DEFAULT NULL,
+    FTS$MIN_SCORE DOUBLE PRECISION DEFAULT NULL,
+    FTS$SORT_FIELD VARCHAR(63) CHARACTER SET UTF8 DEFAULT NULL,
+    FTS$SORT_DESC BOOLEAN DEFAULT FALSE,
+    FTS$FILTER VARCHAR(8191) CHARACTER SET UTF8 DEFAULT NULL,
+    FTS$EXPLAIN_LIMIT INT DEFAULT NULL
 )
 RETURNS (
     FTS$RELATION_NAME VARCHAR(63) CHARACTER SET UTF8,
@@ -806,7 +1038,9 @@ RETURNS (
     FTS$ID INTEGER,
     FTS$UUID CHAR(16) CHARACTER SET OCTETS,
     FTS$SCORE DOUBLE PRECISION,
-    FTS$EXPLANATION BLOB SUB_TYPE TEXT CHARACTER SET UTF8
+    FTS$EXPLANATION BLOB SUB_TYPE TEXT CHARACTER SET UTF8,
+    FTS$DOC_ID INT,
+    FTS$TRUNCATED BOOLEAN
 )
 EXTERNAL NAME 'luceneudr!ftsSearch'
 ENGINE UDR;
@@ -821,11 +1055,38 @@ COMMENT ON PARAMETER FTS$SEARCH.FTS$QUERY IS
 'Full text search expression.';
 
 COMMENT ON PARAMETER FTS$SEARCH.FTS$LIMIT IS
-'Limit on the number of records (search result).';
+'Limit on the number of records (search result). 0 - all records in index order, not sorted by score.';
 
 COMMENT ON PARAMETER FTS$SEARCH.FTS$EXPLAIN IS
 'Explain the search results';
 
+COMMENT ON PARAMETER FTS$SEARCH.FTS$OFFSET IS
+'Number of records to skip before the page.';
+
+COMMENT ON PARAMETER FTS$SEARCH.FTS$AFTER_SCORE IS
+'Score of the last record of the previous page (search cursor).';
+
+COMMENT ON PARAMETER FTS$SEARCH.FTS$AFTER_DOC_ID IS
+'Document number of the last record of the previous page (search cursor).';
+
+COMMENT ON PARAMETER FTS$SEARCH.FTS$TIMEOUT_MS IS
+'Time budget of the search in milliseconds. When it is exhausted, the best records found so far are returned.';
+
+COMMENT ON PARAMETER FTS$SEARCH.FTS$MIN_SCORE IS
+'Minimum score of the returned records.';
+
+COMMENT ON PARAMETER FTS$SEARCH.FTS$SORT_FIELD IS
+'Sortable index field to order the records by instead of the score.';
+
+COMMENT ON PARAMETER FTS$SEARCH.FTS$SORT_DESC IS
+'Order the records by FTS$SORT_FIELD in descending order.';
+
+COMMENT ON PARAMETER FTS$SEARCH.FTS$FILTER IS
+'Filter of the records: FIELD = value terms on sortable index fields joined by AND.';
+
+COMMENT ON PARAMETER FTS$SEARCH.FTS$EXPLAIN_LIMIT IS
+'Number of the first records explained when FTS$EXPLAIN is TRUE. NULL - all records.';
+
 COMMENT ON PARAMETER FTS$SEARCH.FTS$RELATION_NAME IS
 'The name of the table in which the document is found.';
 
@@ -838,9 +1099,216 @@ COMMENT ON PARAMETER FTS$SEARCH.FTS$SCORE IS
 COMMENT ON PARAMETER FTS$SEARCH.FTS$EXPLANATION IS
 'Explanation of the search result';
 
+COMMENT ON PARAMETER FTS$SEARCH.FTS$DOC_ID IS
+'Internal document number. Together with the score it is used as a cursor for the next page.';
+
+COMMENT ON PARAMETER FTS$SEARCH.FTS$TRUNCATED IS
+'The search was stopped by the time budget, the result may be incomplete.';
+
 GRANT SELECT ON TABLE FTS$INDICES TO PROCEDURE FTS$SEARCH;
 GRANT SELECT ON TABLE FTS$INDEX_SEGMENTS TO PROCEDURE FTS$SEARCH;
 
+CREATE OR ALTER PROCEDURE FTS$SEARCH_COUNT (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8
+)
+RETURNS (
+    FTS$COUNT INTEGER
+)
+EXTERNAL NAME 'luceneudr!ftsSearchCount'
+ENGINE UDR;
+
+COMMENT ON PROCEDURE FTS$SEARCH_COUNT IS
+'Returns the number of documents that match the query at the specified index.';
+
+COMMENT ON PARAMETER FTS$SEARCH_COUNT.FTS$INDEX_NAME IS
+'Name of the full-text index to search.';
+
+COMMENT ON PARAMETER FTS$SEARCH_COUNT.FTS$QUERY IS
+'Full text search expression.';
+
+COMMENT ON PARAMETER FTS$SEARCH_COUNT.FTS$COUNT IS
+'Number of matching documents.';
+
+GRANT SELECT ON TABLE FTS$INDICES TO PROCEDURE FTS$SEARCH_COUNT;
+GRANT SELECT ON TABLE FTS$INDEX_SEGMENTS TO PROCEDURE FTS$SEARCH_COUNT;
+
+CREATE OR ALTER PROCEDURE FTS$SEARCH_EXPLAIN (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$LIMIT INT NOT NULL DEFAULT 10
+)
+RETURNS (
+    FTS$DB_KEY CHAR(8) CHARACTER SET OCTETS,
+    FTS$ID INTEGER,
+    FTS$UUID CHAR(16) CHARACTER SET OCTETS,
+    FTS$DOC_ID INT,
+    FTS$SCORE DOUBLE PRECISION,
+    FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$TERM VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$FREQ INT,
+    FTS$TF DOUBLE PRECISION,
+    FTS$IDF DOUBLE PRECISION,
+    FTS$FIELD_NORM DOUBLE PRECISION,
+    FTS$COORD DOUBLE PRECISION
+)
+EXTERNAL NAME 'luceneudr!ftsSearchExplain'
+ENGINE UDR;
+
+COMMENT ON PROCEDURE FTS$SEARCH_EXPLAIN IS
+'Returns the scoring factors of the query terms found in the top documents without building explanation BLOBs.';
+
+COMMENT ON PARAMETER FTS$SEARCH_EXPLAIN.FTS$INDEX_NAME IS
+'Name of the full-text index to search.';
+
+COMMENT ON PARAMETER FTS$SEARCH_EXPLAIN.FTS$QUERY IS
+'Full text search expression.';
+
+COMMENT ON PARAMETER FTS$SEARCH_EXPLAIN.FTS$LIMIT IS
+'Number of the top documents to explain.';
+
+COMMENT ON PARAMETER FTS$SEARCH_EXPLAIN.FTS$SCORE IS
+'The degree of match to the search query.';
+
+COMMENT ON PARAMETER FTS$SEARCH_EXPLAIN.FTS$FIELD_NAME IS
+'Field in which the term is found.';
+
+COMMENT ON PARAMETER FTS$SEARCH_EXPLAIN.FTS$TERM IS
+'Query term found in the document.';
+
+COMMENT ON PARAMETER FTS$SEARCH_EXPLAIN.FTS$FREQ IS
+'Number of occurrences of the term in the field.';
+
+COMMENT ON PARAMETER FTS$SEARCH_EXPLAIN.FTS$TF IS
+'Term frequency factor.';
+
+COMMENT ON PARAMETER FTS$SEARCH_EXPLAIN.FTS$IDF IS
+'Inverse document frequency factor.';
+
+COMMENT ON PARAMETER FTS$SEARCH_EXPLAIN.FTS$FIELD_NORM IS
+'Length normalization and boost of the field.';
+
+COMMENT ON PARAMETER FTS$SEARCH_EXPLAIN.FTS$COORD IS
+'Coordination factor: share of the query terms found in the document.';
+
+GRANT SELECT ON TABLE FTS$INDICES TO PROCEDURE FTS$SEARCH_EXPLAIN;
+GRANT SELECT ON TABLE FTS$INDEX_SEGMENTS TO PROCEDURE FTS$SEARCH_EXPLAIN;
+
+CREATE OR ALTER PROCEDURE FTS$SEARCH_MULTI (
+    FTS$INDEX_NAMES VARCHAR(8191) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$LIMIT INT NOT NULL DEFAULT 1000,
+    FTS$EXPLAIN BOOLEAN DEFAULT FALSE,
+    FTS$EXPLAIN_LIMIT INT DEFAULT NULL
+)
+RETURNS (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$RELATION_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$KEY_FIELD_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$DB_KEY CHAR(8) CHARACTER SET OCTETS,
+    FTS$ID INTEGER,
+    FTS$UUID CHAR(16) CHARACTER SET OCTETS,
+    FTS$SCORE DOUBLE PRECISION,
+    FTS$EXPLANATION BLOB SUB_TYPE TEXT CHARACTER SET UTF8
+)
+EXTERNAL NAME 'luceneudr!ftsSearchMulti'
+ENGINE UDR;
+
+COMMENT ON PROCEDURE FTS$SEARCH_MULTI IS
+'Performs a full-text search at several indexes in parallel and returns one result ranked by score.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$INDEX_NAMES IS
+'Comma-separated list of the full-text indexes to search.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$QUERY IS
+'Full text search expression.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$LIMIT IS
+'Limit on the number of records (search result) over all indexes.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$EXPLAIN IS
+'Explain the search results';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$EXPLAIN_LIMIT IS
+'Number of the first records explained when FTS$EXPLAIN is TRUE. NULL - all records.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$INDEX_NAME IS
+'Name of the full-text index in which the document is found.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$RELATION_NAME IS
+'The name of the table in which the document is found.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$DB_KEY IS
+'Reference to the record in the table where the document was found (corresponds to the RDB$DB_KEY pseudo field).';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$SCORE IS
+'The degree of match to the search query.';
+
+COMMENT ON PARAMETER FTS$SEARCH_MULTI.FTS$EXPLANATION IS
+'Explanation of the search result';
+
+GRANT SELECT ON TABLE FTS$INDICES TO PROCEDURE FTS$SEARCH_MULTI;
+GRANT SELECT ON TABLE FTS$INDEX_SEGMENTS TO PROCEDURE FTS$SEARCH_MULTI;
+
+CREATE OR ALTER PROCEDURE FTS$WARMUP_INDEX (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL
+)
+RETURNS (
+    FTS$STEP VARCHAR(10) CHARACTER SET UTF8,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$ELAPSED_MS DOUBLE PRECISION
+)
+EXTERNAL NAME 'luceneudr!ftsWarmupIndex'
+ENGINE UDR;
+
+COMMENT ON PROCEDURE FTS$WARMUP_INDEX IS
+'Loads the full-text index into the process cache and runs its warm-up queries, reports the time taken per step.';
+
+COMMENT ON PARAMETER FTS$WARMUP_INDEX.FTS$INDEX_NAME IS
+'Name of the full-text index to warm up.';
+
+COMMENT ON PARAMETER FTS$WARMUP_INDEX.FTS$STEP IS
+'Warm-up step: OPEN - open the searcher, NORMS - load the norms, KEYS - load the key column, QUERY - run a warm-up query.';
+
+COMMENT ON PARAMETER FTS$WARMUP_INDEX.FTS$QUERY IS
+'Warm-up query of the QUERY step.';
+
+COMMENT ON PARAMETER FTS$WARMUP_INDEX.FTS$ELAPSED_MS IS
+'Time taken by the step in milliseconds.';
+
+GRANT SELECT ON TABLE FTS$INDICES TO PROCEDURE FTS$WARMUP_INDEX;
+GRANT SELECT ON TABLE FTS$INDEX_SEGMENTS TO PROCEDURE FTS$WARMUP_INDEX;
+GRANT SELECT ON TABLE FTS$WARMUP_QUERIES TO PROCEDURE FTS$WARMUP_INDEX;
+
+CREATE OR ALTER PROCEDURE FTS$WARMUP_ALL
+RETURNS (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$STEP VARCHAR(10) CHARACTER SET UTF8,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$ELAPSED_MS DOUBLE PRECISION
+)
+EXTERNAL NAME 'luceneudr!ftsWarmupAll'
+ENGINE UDR;
+
+COMMENT ON PROCEDURE FTS$WARMUP_ALL IS
+'Warms up all active full-text indexes, reports the time taken per step.';
+
+COMMENT ON PARAMETER FTS$WARMUP_ALL.FTS$INDEX_NAME IS
+'Name of the full-text index.';
+
+COMMENT ON PARAMETER FTS$WARMUP_ALL.FTS$STEP IS
+'Warm-up step: OPEN - open the searcher, NORMS - load the norms, KEYS - load the key column, QUERY - run a warm-up query.';
+
+COMMENT ON PARAMETER FTS$WARMUP_ALL.FTS$QUERY IS
+'Warm-up query of the QUERY step.';
+
+COMMENT ON PARAMETER FTS$WARMUP_ALL.FTS$ELAPSED_MS IS
+'Time taken by the step in milliseconds.';
+
+GRANT SELECT ON TABLE FTS$INDICES TO PROCEDURE FTS$WARMUP_ALL;
+GRANT SELECT ON TABLE FTS$INDEX_SEGMENTS TO PROCEDURE FTS$WARMUP_ALL;
+GRANT SELECT ON TABLE FTS$WARMUP_QUERIES TO PROCEDURE FTS$WARMUP_ALL;
+
 CREATE OR ALTER PROCEDURE FTS$ANALYZE (
     FTS$TEXT     BLOB SUB_TYPE TEXT CHARACTER SET UTF8,
     FTS$ANALYZER VARCHAR(63) CHARACTER SET UTF8 NOT NULL DEFAULT 'STANDARD'
@@ -862,13 +1330,18 @@ COMMENT ON PARAMETER FTS$ANALYZE.FTS$ANALYZER IS
 COMMENT ON PARAMETER FTS$ANALYZE.FTS$TERM IS
 'Term';
 
-CREATE OR ALTER PROCEDURE FTS$UPDATE_INDEXES
+CREATE OR ALTER PROCEDURE FTS$UPDATE_INDEXES (
+    FTS$NEAR_REAL_TIME BOOLEAN DEFAULT FALSE
+)
 EXTERNAL NAME 'luceneudr!updateFtsIndexes' 
 ENGINE UDR;
 
 COMMENT ON PROCEDURE FTS$UPDATE_INDEXES IS
 'Updates full-text indexes on entries in the FTS$LOG change log.';
 
+COMMENT ON PARAMETER FTS$UPDATE_INDEXES.FTS$NEAR_REAL_TIME IS
+'Keep the index writers open, the changes become searchable without a commit';
+
 GRANT SELECT ON TABLE FTS$INDICES TO PROCEDURE FTS$UPDATE_INDEXES;
 GRANT SELECT ON TABLE FTS$INDEX_SEGMENTS TO PROCEDURE FTS$UPDATE_INDEXES;
 GRANT SELECT, DELETE ON TABLE FTS$LOG TO PROCEDURE FTS$UPDATE_INDEXES;
@@ -1402,6 +1875,25 @@ BEGIN
       FTS$TERM       VARCHAR(8191) CHARACTER SET UTF8,
       FTS$DOC_FREQ   INTEGER
   );
+
+  /**
+   * Returns the counters of the process-wide caches.
+   *
+   * Output parameters:
+   *   FTS$CACHE_NAME - cache name (QUERY - parsed search queries, FILTER - search filters, RESULT - top search results);
+   *   FTS$CAPACITY - max number of cache entries (for RESULT - max memory in bytes);
+   *   FTS$SIZE - current number of cache entries (for RESULT - memory in bytes);
+   *   FTS$HITS - number of cache hits;
+   *   FTS$MISSES - number of cache misses.
+  **/
+  PROCEDURE FTS$CACHE_STATISTICS
+  RETURNS (
+      FTS$CACHE_NAME VARCHAR(63) CHARACTER SET UTF8,
+      FTS$CAPACITY   INTEGER,
+      FTS$SIZE       INTEGER,
+      FTS$HITS       INTEGER,
+      FTS$MISSES     INTEGER
+  );
 END^
 
 RECREATE PACKAGE BODY FTS$STATISTICS
@@ -1551,6 +2043,18 @@ BEGIN
   )
   EXTERNAL NAME 'luceneudr!indexTerms'
   ENGINE UDR;
+
+
+  PROCEDURE FTS$CACHE_STATISTICS
+  RETURNS (
+      FTS$CACHE_NAME VARCHAR(63) CHARACTER SET UTF8,
+      FTS$CAPACITY   INTEGER,
+      FTS$SIZE       INTEGER,
+      FTS$HITS       INTEGER,
+      FTS$MISSES     INTEGER
+  )
+  EXTERNAL NAME 'luceneudr!getCacheStatistics'
+  ENGINE UDR;
 END^
 
 SET TERM ; ^
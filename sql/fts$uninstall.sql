@@ -16,16 +16,25 @@ DROP PACKAGE FTS$TRIGGER_HELPER;
 DROP PACKAGE FTS$HIGHLIGHTER;
 DROP PACKAGE FTS$STATISTICS;
 DROP PROCEDURE FTS$SEARCH;
+DROP PROCEDURE FTS$SEARCH_COUNT;
+DROP PROCEDURE FTS$SEARCH_EXPLAIN;
+DROP PROCEDURE FTS$SEARCH_MULTI;
+DROP PROCEDURE FTS$WARMUP_INDEX;
+DROP PROCEDURE FTS$WARMUP_ALL;
 DROP PROCEDURE FTS$ANALYZE;
 DROP PROCEDURE FTS$UPDATE_INDEXES;
 DROP FUNCTION FTS$ESCAPE_QUERY;
 DROP TABLE FTS$LOG;
+DROP TABLE FTS$WARMUP_QUERIES;
 DROP TABLE FTS$INDEX_SEGMENTS;
 DROP TABLE FTS$INDICES;
 DROP TABLE FTS$STOP_WORDS;
 DROP TABLE FTS$ANALYZERS;
+DROP SEQUENCE FTS$STOP_WORDS_VERSION;
 DROP DOMAIN FTS$D_INDEX_STATUS;
 DROP DOMAIN FTS$D_CHANGE_TYPE;
+DROP DOMAIN FTS$D_KEY_ENCODING;
+DROP DOMAIN FTS$D_STORAGE;
 DROP EXCEPTION FTS$EXCEPTION;
 
 COMMIT;
@@ -2,3 +2,84 @@ DROP PROCEDURE FTS$LOG_BY_DBKEY;
 DROP PROCEDURE FTS$LOG_BY_UUID;
 DROP PROCEDURE FTS$LOG_BY_ID;
 DROP PROCEDURE FTS$CLEAR_LOG;
+
+ALTER TABLE FTS$ANALYZERS
+ADD FTS$STOP_WORDS_VERSION BIGINT DEFAULT 0 NOT NULL;
+
+COMMENT ON COLUMN FTS$ANALYZERS.FTS$STOP_WORDS_VERSION IS 
+'Version of the stop words list. Changes every time a stop word is added or deleted';
+
+CREATE SEQUENCE FTS$STOP_WORDS_VERSION;
+
+COMMENT ON SEQUENCE FTS$STOP_WORDS_VERSION IS 
+'Source of versions for stop words lists of custom analyzers';
+
+GRANT UPDATE ON FTS$ANALYZERS TO PACKAGE FTS$MANAGEMENT;
+GRANT USAGE ON SEQUENCE FTS$STOP_WORDS_VERSION TO PACKAGE FTS$MANAGEMENT;
+
+CREATE DOMAIN FTS$D_KEY_ENCODING
+VARCHAR(10) CHARACTER SET UTF8
+CHECK (VALUE IN ('TEXT', 'BINARY'));
+
+COMMENT ON DOMAIN FTS$D_KEY_ENCODING IS
+'Format of the key values in the full-text index. TEXT - hex or decimal string, BINARY - raw bytes or trie-encoded number.';
+
+-- Existing indexes keep the text format on disk until they are rebuilt.
+ALTER TABLE FTS$INDICES
+ADD FTS$KEY_ENCODING FTS$D_KEY_ENCODING DEFAULT 'BINARY' NOT NULL;
+
+COMMENT ON COLUMN FTS$INDICES.FTS$KEY_ENCODING IS
+'Format of the key values. Applied when the index is built or rebuilt.';
+
+ALTER TABLE FTS$INDICES
+ADD FTS$PARALLELISM SMALLINT DEFAULT 1 NOT NULL;
+
+COMMENT ON COLUMN FTS$INDICES.FTS$PARALLELISM IS
+'Max number of threads searching the index segments in parallel. 1 - the search runs on one thread.';
+
+CREATE DOMAIN FTS$D_STORAGE
+VARCHAR(10) CHARACTER SET UTF8
+CHECK (VALUE IN ('FS', 'MMAP', 'RAM'));
+
+COMMENT ON DOMAIN FTS$D_STORAGE IS
+'Storage of the full-text index. FS - files read through buffers, MMAP - memory-mapped files, RAM - in-memory copy of the files for searching.';
+
+ALTER TABLE FTS$INDICES
+ADD FTS$STORAGE FTS$D_STORAGE DEFAULT 'FS' NOT NULL;
+
+COMMENT ON COLUMN FTS$INDICES.FTS$STORAGE IS
+'Storage used to read the index. Does not require the index to be rebuilt.';
+
+ALTER TABLE FTS$INDICES
+ADD FTS$MERGE_FACTOR SMALLINT DEFAULT 10 NOT NULL;
+
+COMMENT ON COLUMN FTS$INDICES.FTS$MERGE_FACTOR IS
+'Number of segments of similar size merged into one segment when the index is updated. Does not require the index to be rebuilt.';
+
+ALTER TABLE FTS$INDEX_SEGMENTS
+ADD FTS$SORTABLE BOOLEAN DEFAULT FALSE NOT NULL;
+
+COMMENT ON COLUMN FTS$INDEX_SEGMENTS.FTS$SORTABLE IS
+'Can the search results be sorted by the field';
+
+CREATE TABLE FTS$WARMUP_QUERIES (
+  FTS$QUERY_ID            BIGINT GENERATED BY DEFAULT AS IDENTITY,
+  FTS$INDEX_NAME          VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+  FTS$QUERY               VARCHAR(8191) CHARACTER SET UTF8 NOT NULL,
+  CONSTRAINT PK_FTS$WARMUP_QUERIES PRIMARY KEY(FTS$QUERY_ID),
+  CONSTRAINT FK_FTS$WARMUP_QUERIES FOREIGN KEY(FTS$INDEX_NAME) REFERENCES FTS$INDICES(FTS$INDEX_NAME) ON DELETE CASCADE
+);
+
+COMMENT ON TABLE FTS$WARMUP_QUERIES IS
+'Queries run by FTS$WARMUP_INDEX and FTS$WARMUP_ALL to warm up full-text indexes.';
+
+COMMENT ON COLUMN FTS$WARMUP_QUERIES.FTS$QUERY_ID IS
+'Identifier. Queries run in the order of identifiers.';
+
+COMMENT ON COLUMN FTS$WARMUP_QUERIES.FTS$INDEX_NAME IS
+'Full-text index name.';
+
+COMMENT ON COLUMN FTS$WARMUP_QUERIES.FTS$QUERY IS
+'Full text search expression.';
+
+COMMIT;
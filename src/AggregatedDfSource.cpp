@@ -0,0 +1,84 @@
+/**
+ *  Document frequencies of several indexes for scoring them together.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "AggregatedDfSource.h"
+
+namespace Lucene
+{
+
+    AggregatedDfSource::AggregatedDfSource(Collection<SearcherPtr> searchers)
+        : searchers(searchers)
+        , _maxDoc(0)
+    {
+        for (const auto& searcher : searchers) {
+            _maxDoc += searcher->maxDoc();
+        }
+        // the weights are normalized the same way as by the searchers of the indexes
+        if (!searchers.empty()) {
+            setSimilarity(searchers[0]->getSimilarity());
+        }
+    }
+
+    AggregatedDfSource::~AggregatedDfSource() {
+    }
+
+    int32_t AggregatedDfSource::docFreq(const TermPtr& term) {
+        int32_t df = 0;
+        for (const auto& searcher : searchers) {
+            df += searcher->docFreq(term);
+        }
+        return df;
+    }
+
+    int32_t AggregatedDfSource::maxDoc() {
+        return _maxDoc;
+    }
+
+    QueryPtr AggregatedDfSource::rewrite(const QueryPtr& query) {
+        return query;
+    }
+
+    void AggregatedDfSource::close() {
+        boost::throw_exception(UnsupportedOperationException());
+    }
+
+    DocumentPtr AggregatedDfSource::doc(int32_t n) {
+        boost::throw_exception(UnsupportedOperationException());
+        return DocumentPtr();
+    }
+
+    DocumentPtr AggregatedDfSource::doc(int32_t n, const FieldSelectorPtr& fieldSelector) {
+        boost::throw_exception(UnsupportedOperationException());
+        return DocumentPtr();
+    }
+
+    ExplanationPtr AggregatedDfSource::explain(const WeightPtr& weight, int32_t doc) {
+        boost::throw_exception(UnsupportedOperationException());
+        return ExplanationPtr();
+    }
+
+    void AggregatedDfSource::search(const WeightPtr& weight, const FilterPtr& filter, const CollectorPtr& results) {
+        boost::throw_exception(UnsupportedOperationException());
+    }
+
+    TopDocsPtr AggregatedDfSource::search(const WeightPtr& weight, const FilterPtr& filter, int32_t n) {
+        boost::throw_exception(UnsupportedOperationException());
+        return TopDocsPtr();
+    }
+
+    TopFieldDocsPtr AggregatedDfSource::search(const WeightPtr& weight, const FilterPtr& filter, int32_t n, const SortPtr& sort) {
+        boost::throw_exception(UnsupportedOperationException());
+        return TopFieldDocsPtr();
+    }
+
+}
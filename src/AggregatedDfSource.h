@@ -0,0 +1,61 @@
+#ifndef LUCENE_AGGREGATED_DF_SOURCE_H
+#define LUCENE_AGGREGATED_DF_SOURCE_H
+
+/**
+ *  Document frequencies of several indexes for scoring them together.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "LuceneHeaders.h"
+#include "Searcher.h"
+
+namespace Lucene
+{
+    /// Searcher that only gives the document frequencies and the number of documents summed over several searchers.
+    ///
+    /// A rewritten query weighted with it gets idf and query norm from the statistics of all indexes,
+    /// like MultiSearcher does, so the scores of the documents of different indexes are comparable.
+    /// The weight is then used with the searcher of its own index. Only the methods used to create weights are supported.
+    class AggregatedDfSource : public Searcher {
+    public:
+        AggregatedDfSource(Collection<SearcherPtr> searchers);
+
+        virtual ~AggregatedDfSource();
+
+        LUCENE_CLASS(AggregatedDfSource);
+
+    public:
+        using Searcher::search;
+        using Searcher::explain;
+
+        virtual int32_t docFreq(const TermPtr& term);
+        virtual int32_t maxDoc();
+
+        /// The query is already rewritten by the searcher of its index.
+        virtual QueryPtr rewrite(const QueryPtr& query);
+
+        virtual void close();
+        virtual DocumentPtr doc(int32_t n);
+        virtual DocumentPtr doc(int32_t n, const FieldSelectorPtr& fieldSelector);
+        virtual ExplanationPtr explain(const WeightPtr& weight, int32_t doc);
+        virtual void search(const WeightPtr& weight, const FilterPtr& filter, const CollectorPtr& results);
+        virtual TopDocsPtr search(const WeightPtr& weight, const FilterPtr& filter, int32_t n);
+        virtual TopFieldDocsPtr search(const WeightPtr& weight, const FilterPtr& filter, int32_t n, const SortPtr& sort);
+
+    protected:
+        Collection<SearcherPtr> searchers;
+        int32_t _maxDoc;
+    };
+
+    typedef boost::shared_ptr<AggregatedDfSource> AggregatedDfSourcePtr;
+}
+
+#endif // LUCENE_AGGREGATED_DF_SOURCE_H
@@ -13,6 +13,10 @@
 
 #include "Analyzers.h"
 
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
 #include "FBUtils.h"
 #include "LuceneAnalyzerFactory.h"
 
@@ -54,6 +58,87 @@ FROM FTS$STOP_WORDS W
 WHERE W.FTS$ANALYZER_NAME = ?
 )SQL";
 
+    constexpr const char* SQL_ANALYZER_VERSION = R"SQL(
+SELECT
+    A.FTS$BASE_ANALYZER
+  , A.FTS$STOP_WORDS_VERSION
+  , RDB$GET_CONTEXT('SYSTEM', 'DB_NAME') AS DB_NAME
+FROM FTS$ANALYZERS A
+WHERE A.FTS$ANALYZER_NAME = ?
+)SQL";
+
+    /// <summary>
+    /// Process-wide cache of analyzers.
+    ///
+    /// System analyzers never change, so they are cached by name only.
+    /// Custom analyzers are cached per database and are replaced when
+    /// the base analyzer or the stop words version changes.
+    /// </summary>
+    class AnalyzerCache final
+    {
+    public:
+        static AnalyzerCache& instance()
+        {
+            static AnalyzerCache cache;
+            return cache;
+        }
+
+        AnalyzerPtr getSystemAnalyzer(
+            ThrowStatusWrapper* status,
+            const LuceneAnalyzerFactory& factory,
+            std::string_view analyzerName
+        )
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_systemAnalyzers.find(analyzerName);
+            if (it == m_systemAnalyzers.end()) {
+                auto analyzer = factory.createAnalyzer(status, analyzerName);
+                it = m_systemAnalyzers.emplace(analyzerName, analyzer).first;
+            }
+            return it->second;
+        }
+
+        AnalyzerPtr findCustomAnalyzer(
+            const std::string& key,
+            std::string_view baseAnalyzer,
+            ISC_INT64 version
+        )
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = m_customAnalyzers.find(key);
+            if (it != m_customAnalyzers.end() && it->second.baseAnalyzer == baseAnalyzer && it->second.version == version) {
+                return it->second.analyzer;
+            }
+            return nullptr;
+        }
+
+        void putCustomAnalyzer(
+            const std::string& key,
+            std::string_view baseAnalyzer,
+            ISC_INT64 version,
+            const AnalyzerPtr& analyzer
+        )
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_customAnalyzers[key] = { std::string(baseAnalyzer), version, analyzer };
+        }
+
+    private:
+        AnalyzerCache() = default;
+
+        struct CustomAnalyzer
+        {
+            std::string baseAnalyzer;
+            ISC_INT64 version = 0;
+            AnalyzerPtr analyzer;
+        };
+
+        std::mutex m_mutex;
+        std::map<std::string, AnalyzerPtr, ci_less> m_systemAnalyzers;
+        // key - database name and analyzer name
+        std::unordered_map<std::string, CustomAnalyzer> m_customAnalyzers;
+    };
+
 }
 
 namespace FTSMetadata
@@ -61,13 +146,10 @@ namespace FTSMetadata
 
     AnalyzerRepository::AnalyzerRepository(IMaster* master)
         : m_master(master)
-        , m_analyzerFactory(new LuceneAnalyzerFactory())
+        , m_analyzerFactory(&LuceneAnalyzerFactory::instance())
     {}
 
-    AnalyzerRepository::~AnalyzerRepository()
-    {
-        delete m_analyzerFactory;
-    }
+    AnalyzerRepository::~AnalyzerRepository() = default;
 
     AnalyzerPtr AnalyzerRepository::createAnalyzer(
         ThrowStatusWrapper* status,
@@ -77,15 +159,70 @@ namespace FTSMetadata
         std::string_view analyzerName
     )
     {
+        auto& analyzerCache = AnalyzerCache::instance();
         if (m_analyzerFactory->hasAnalyzer(analyzerName)) {
-            return m_analyzerFactory->createAnalyzer(status, analyzerName);
+            return analyzerCache.getSystemAnalyzer(status, *m_analyzerFactory, analyzerName);
+        }
+
+        FB_MESSAGE(Input, ThrowStatusWrapper,
+            (FB_INTL_VARCHAR(252, CS_UTF8), analyzerName)
+        ) input(status, m_master);
+
+        FB_MESSAGE(Output, ThrowStatusWrapper,
+            (FB_INTL_VARCHAR(252, CS_UTF8), baseAnalyzer)
+            (FB_BIGINT, version)
+            (FB_VARCHAR(1020), dbName)
+        ) output(status, m_master);
+
+        input.clear();
+        input->analyzerName.length = static_cast<ISC_USHORT>(analyzerName.length());
+        analyzerName.copy(input->analyzerName.str, input->analyzerName.length);
+
+        if (!m_stmt_get_version.hasData()) {
+            m_stmt_get_version.reset(att->prepare(
+                status,
+                tra,
+                0,
+                SQL_ANALYZER_VERSION,
+                sqlDialect,
+                IStatement::PREPARE_PREFETCH_METADATA
+            ));
         }
-        const auto info = getAnalyzerInfo(status, att, tra, sqlDialect, analyzerName);
-        if (!m_analyzerFactory->hasAnalyzer(info.baseAnalyzer)) {
-            throwException(status, R"(Base analyzer "%s" not exists)", info.baseAnalyzer.c_str());
+
+        AutoRelease<IResultSet> rs(m_stmt_get_version->openCursor(
+            status,
+            tra,
+            input.getMetadata(),
+            input.getData(),
+            output.getMetadata(),
+            0
+        ));
+
+        int result = rs->fetchNext(status, output.getData());
+        rs->close(status);
+        rs.release();
+
+        if (result == IStatus::RESULT_NO_DATA) {
+            std::string sAnalyzerName{ analyzerName };
+            throwException(status, R"(Analyzer "%s" not exists)", sAnalyzerName.c_str());
+        }
+
+        const std::string baseAnalyzer(output->baseAnalyzer.str, output->baseAnalyzer.length);
+        if (!m_analyzerFactory->hasAnalyzer(baseAnalyzer)) {
+            throwException(status, R"(Base analyzer "%s" not exists)", baseAnalyzer.c_str());
+        }
+
+        std::string cacheKey(output->dbName.str, output->dbName.length);
+        cacheKey += '\0';
+        cacheKey += analyzerName;
+
+        auto analyzer = analyzerCache.findCustomAnalyzer(cacheKey, baseAnalyzer, output->version);
+        if (!analyzer) {
+            const auto stopWords = getStopWords(status, att, tra, sqlDialect, analyzerName);
+            analyzer = m_analyzerFactory->createAnalyzer(status, baseAnalyzer, stopWords);
+            analyzerCache.putCustomAnalyzer(cacheKey, baseAnalyzer, output->version, analyzer);
         }
-        const auto stopWords = getStopWords(status, att, tra, sqlDialect, analyzerName);
-        return m_analyzerFactory->createAnalyzer(status, info.baseAnalyzer, stopWords);
+        return analyzer;
     }
 
     AnalyzerInfo AnalyzerRepository::getAnalyzerInfo(
@@ -33,12 +33,13 @@ namespace FTSMetadata
     {
     private:
         Firebird::IMaster* m_master = nullptr;
-        LuceneUDR::LuceneAnalyzerFactory* m_analyzerFactory = nullptr;
+        const LuceneUDR::LuceneAnalyzerFactory* m_analyzerFactory = nullptr;
 
         // prepared statements
         Firebird::AutoRelease<Firebird::IStatement> m_stmt_get_analyzer;
         Firebird::AutoRelease<Firebird::IStatement> m_stmt_has_analyzer;
         Firebird::AutoRelease<Firebird::IStatement> m_stmt_get_stopwords;
+        Firebird::AutoRelease<Firebird::IStatement> m_stmt_get_version;
 
     public:
         AnalyzerRepository() = delete;
@@ -56,6 +57,12 @@ namespace FTSMetadata
         ~AnalyzerRepository();
 
 
+        /// <summary>
+        /// Returns the analyzer by name.
+        ///
+        /// Analyzers are immutable and shared by all attachments of the process.
+        /// A custom analyzer is built again only after its stop words have been changed.
+        /// </summary>
         Lucene::AnalyzerPtr createAnalyzer (
             Firebird::ThrowStatusWrapper* status,
             Firebird::IAttachment* att,
@@ -11,20 +11,44 @@
  *  Contributor(s): ______________________________________.
 **/
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "AggregatedDfSource.h"
 #include "Analyzers.h"
+#include "CachingWrapperFilter.h"
 #include "FBUtils.h"
+#include "FTSFilterCache.h"
 #include "FTSHelper.h"
+#include "FTSHitStream.h"
 #include "FTSIndex.h"
+#include "FTSLogRanges.h"
+#include "FTSParallelSearch.h"
+#include "FTSQueryCache.h"
+#include "FTSResultCache.h"
+#include "FTSSearcherCache.h"
 #include "FTSUtils.h"
+#include "FilteredQuery.h"
+#include "HitCountCollector.h"
 #include "LuceneAnalyzerFactory.h"
 #include "LuceneUdr.h"
 #include "LuceneHeaders.h"
+#include "QueryWrapperFilter.h"
 #include "Relations.h"
+#include "SearchAfterCollector.h"
 #include "TermAttribute.h"
+#include "TimeLimitingCollector.h"
+#include "TopFieldCollector.h"
+#include "WorkerPool.h"
 
 
 
@@ -55,6 +79,503 @@ namespace {
 
         return s;
     }
+
+    // Parses the search query over all indexed fields except the key.
+    // Parsed queries are shared through the process-wide query cache,
+    // the key includes the database because index names are unique only within it.
+    QueryPtr parseQuery(const std::string& databaseName, const FTSIndex& ftsIndex, const AnalyzerPtr& analyzer, const std::string& queryStr)
+    {
+        std::string cacheKey = databaseName;
+        cacheKey += '\0';
+        cacheKey += ftsIndex.indexName;
+        cacheKey += '\0';
+        cacheKey += ftsIndex.analyzer;
+        cacheKey += '\0';
+        auto fields = Collection<String>::newInstance();
+        for (const auto& segment : ftsIndex.segments) {
+            if (!segment.isKey()) {
+                fields.add(StringUtils::toUnicode(segment.fieldName()));
+                cacheKey += segment.fieldName();
+                cacheKey += '\1';
+            }
+        }
+        cacheKey += '\0';
+        cacheKey += queryStr;
+
+        auto& queryCache = FTSQueryCache::instance();
+        if (auto query = queryCache.get(cacheKey, analyzer)) {
+            return query;
+        }
+
+        QueryPtr query;
+        if (fields.size() == 1) {
+            QueryParserPtr parser = newLucene<QueryParser>(LuceneVersion::LUCENE_CURRENT, fields[0], analyzer);
+            query = parser->parse(StringUtils::toUnicode(queryStr));
+        }
+        else {
+            MultiFieldQueryParserPtr parser = newLucene<MultiFieldQueryParser>(LuceneVersion::LUCENE_CURRENT, fields, analyzer);
+            parser->setDefaultOperator(QueryParser::OR_OPERATOR);
+            query = parser->parse(StringUtils::toUnicode(queryStr));
+        }
+        queryCache.put(cacheKey, analyzer, query);
+        return query;
+    }
+
+    // Parses the filter of FTS$SEARCH: FIELD = value terms joined by AND.
+    // A value with spaces is enclosed in single quotes, a quote inside it is doubled.
+    std::vector<std::pair<std::string, std::string>> parseFilter(std::string_view filter)
+    {
+        const auto skipSpaces = [&filter]() {
+            while (!filter.empty() && std::isspace(static_cast<unsigned char>(filter.front()))) {
+                filter.remove_prefix(1);
+            }
+        };
+
+        std::vector<std::pair<std::string, std::string>> terms;
+        skipSpaces();
+        while (!filter.empty()) {
+            if (!terms.empty()) {
+                if (filter.size() < 4 || std::toupper(static_cast<unsigned char>(filter[0])) != 'A' ||
+                    std::toupper(static_cast<unsigned char>(filter[1])) != 'N' ||
+                    std::toupper(static_cast<unsigned char>(filter[2])) != 'D' ||
+                    !std::isspace(static_cast<unsigned char>(filter[3])))
+                {
+                    throw std::invalid_argument("Invalid FTS$FILTER. Terms must be joined by AND");
+                }
+                filter.remove_prefix(4);
+                skipSpaces();
+            }
+
+            const auto p = filter.find('=');
+            if (p == std::string_view::npos) {
+                throw std::invalid_argument("Invalid FTS$FILTER. Expected FIELD = value");
+            }
+            auto fieldName = filter.substr(0, p);
+            while (!fieldName.empty() && std::isspace(static_cast<unsigned char>(fieldName.back()))) {
+                fieldName.remove_suffix(1);
+            }
+            if (fieldName.empty()) {
+                throw std::invalid_argument("Invalid FTS$FILTER. Field name is missing");
+            }
+            filter.remove_prefix(p + 1);
+            skipSpaces();
+
+            std::string value;
+            if (!filter.empty() && filter.front() == '\'') {
+                filter.remove_prefix(1);
+                while (true) {
+                    const auto q = filter.find('\'');
+                    if (q == std::string_view::npos) {
+                        throw std::invalid_argument("Invalid FTS$FILTER. Unterminated quoted value");
+                    }
+                    value += filter.substr(0, q);
+                    filter.remove_prefix(q + 1);
+                    if (filter.empty() || filter.front() != '\'') {
+                        break;
+                    }
+                    value += '\'';
+                    filter.remove_prefix(1);
+                }
+            }
+            else {
+                size_t q = 0;
+                while (q < filter.size() && !std::isspace(static_cast<unsigned char>(filter[q]))) {
+                    q++;
+                }
+                if (q == 0) {
+                    throw std::invalid_argument("Invalid FTS$FILTER. Value is missing");
+                }
+                value = filter.substr(0, q);
+                filter.remove_prefix(q);
+            }
+            terms.emplace_back(fieldName, std::move(value));
+            skipSpaces();
+        }
+        return terms;
+    }
+
+    // Returns the filter of the FTS$SEARCH filter terms. The terms are matched against the not analyzed
+    // values of the sortable fields. Filters are shared through the process-wide filter cache,
+    // so their document sets are reused by the following searches over the same segments.
+    FilterPtr makeFilter(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        RelationHelper& relationHelper,
+        const FTSIndex& ftsIndex,
+        const fs::path& indexDirectoryPath,
+        const FTSSearcherPtr& ftsSearcher,
+        std::string_view filterStr)
+    {
+        std::vector<std::pair<std::string, std::string>> terms;
+        try {
+            terms = parseFilter(filterStr);
+        }
+        catch (const std::invalid_argument& e) {
+            throwException(status, e.what());
+        }
+        if (terms.empty()) {
+            return nullptr;
+        }
+
+        std::string cacheKey = indexDirectoryPath.u8string();
+        auto filterQuery = newLucene<BooleanQuery>();
+        for (const auto& [fieldName, value] : terms) {
+            const auto iSegment = ftsIndex.findSegment(fieldName);
+            if (iSegment == ftsIndex.segments.cend()) {
+                throwException(status, R"(Field "%s" not exists in index "%s")", fieldName.c_str(), ftsIndex.indexName.c_str());
+            }
+            if (!iSegment->isSortable()) {
+                throwException(status, R"(Field "%s" of index "%s" is not sortable and can not be filtered)",
+                    fieldName.c_str(), ftsIndex.indexName.c_str());
+            }
+            const auto fieldInfo = relationHelper.getField(status, att, tra, sqlDialect, ftsIndex.relationName, fieldName);
+            const auto sortType = getSortType(fieldInfo);
+            String term;
+            try {
+                term = makeSortTerm(value, sortType);
+            }
+            catch (const std::logic_error&) {
+                throwException(status, R"(Invalid value "%s" of field "%s" in FTS$FILTER)", value.c_str(), fieldName.c_str());
+            }
+            filterQuery->add(newLucene<TermQuery>(newLucene<Term>(getSortFieldName(fieldName), term)), BooleanClause::MUST);
+
+            cacheKey += '\0';
+            cacheKey += fieldName;
+            cacheKey += '\1';
+            cacheKey += static_cast<char>('0' + static_cast<int>(sortType));
+            cacheKey += value;
+        }
+
+        auto& filterCache = FTSFilterCache::instance();
+        if (auto filter = filterCache.get(cacheKey, ftsSearcher)) {
+            return filter;
+        }
+        FilterPtr filter = newLucene<CachingWrapperFilter>(newLucene<QueryWrapperFilter>(filterQuery));
+        filterCache.put(cacheKey, filter, ftsSearcher);
+        return filter;
+    }
+
+    // Makes the result cache key of FTS$SEARCH: query text, filter, score cutoff, sort and paging parameters.
+    std::string makeSearchKey(const std::string& queryStr, const std::string& filterStr, int32_t offset, int32_t limit, double minScore,
+        const std::string& sortFieldName, bool sortDesc, bool afterNull, double afterScore, int32_t afterDocId)
+    {
+        std::string searchKey = queryStr;
+        searchKey += '\0';
+        searchKey += filterStr;
+        searchKey += '\0';
+        searchKey += std::to_string(offset);
+        searchKey += ' ';
+        searchKey += std::to_string(limit);
+        searchKey += ' ';
+        searchKey.append(reinterpret_cast<const char*>(&minScore), sizeof(minScore));
+        if (!sortFieldName.empty()) {
+            searchKey += '\0';
+            searchKey += sortFieldName;
+            searchKey += sortDesc ? " DESC" : " ASC";
+        }
+        if (!afterNull) {
+            // the score is kept exactly
+            searchKey += ' ';
+            searchKey.append(reinterpret_cast<const char*>(&afterScore), sizeof(afterScore));
+            searchKey += std::to_string(afterDocId);
+        }
+        return searchKey;
+    }
+
+    // Collects the hits of the query with a score not less than minScore. When the time budget is exhausted,
+    // the collection is stopped and the collector keeps the hits found so far.
+    // Returns false if the collection was stopped.
+    bool collectHits(const SearcherPtr& searcher, const QueryPtr& query, const CollectorPtr& collector,
+        double minScore, int64_t timeoutMs)
+    {
+        try {
+            searcher->search(query, limitCollector(collector, minScore, timeoutMs));
+        }
+        catch (const TimeExceededException&) {
+            return false;
+        }
+        return true;
+    }
+
+    // Writes the key of the found document to the output message of a search procedure.
+    template <class Message>
+    void writeKey(
+        ThrowStatusWrapper* status,
+        Message* out,
+        FTSSearcher& ftsSearcher,
+        const String& unicodeKeyFieldName,
+        const RelationFieldInfo& keyFieldInfo,
+        int32_t doc)
+    {
+        out->dbKeyNull = true;
+        out->uuidNull = true;
+        out->idNull = true;
+        try {
+            if (keyFieldInfo.isDbKey()) {
+                // Convert the key term back to binary format according to the index key encoding.
+                auto dbKey = keyTermToBinary(ftsSearcher.getKey(unicodeKeyFieldName, doc), ftsSearcher.keyEncoding());
+                std::string_view svDbKey(reinterpret_cast<char*>(dbKey.data()), dbKey.size());
+                out->dbKeyNull = false;
+                out->dbKey.length = static_cast<ISC_USHORT>(svDbKey.size());
+                svDbKey.copy(out->dbKey.str, out->dbKey.length);
+            }
+            else if (keyFieldInfo.isBinary()) {
+                // Convert the key term back to binary format according to the index key encoding.
+                auto uuid = keyTermToBinary(ftsSearcher.getKey(unicodeKeyFieldName, doc), ftsSearcher.keyEncoding());
+                std::string_view svUuid(reinterpret_cast<char*>(uuid.data()), uuid.size());
+                out->uuidNull = false;
+                out->uuid.length = static_cast<ISC_USHORT>(svUuid.size());
+                svUuid.copy(out->uuid.str, out->uuid.length);
+            }
+            else if (keyFieldInfo.isInt()) {
+                out->idNull = false;
+                out->id = ftsSearcher.getIntKey(unicodeKeyFieldName, doc);
+            }
+            else {
+                std::string sMessage = "FTS index does not know the key type.";
+                throwException(status, sMessage.c_str());
+            }
+        }
+        catch (const std::invalid_argument& e) {
+            throwException(status, e.what());
+        }
+    }
+
+    // Splits the comma-separated list of index names, the names are trimmed and duplicates are skipped.
+    std::vector<std::string> splitIndexNames(std::string_view indexNames)
+    {
+        std::vector<std::string> names;
+        while (!indexNames.empty()) {
+            const auto p = indexNames.find(',');
+            auto name = indexNames.substr(0, p);
+            indexNames.remove_prefix(p == std::string_view::npos ? indexNames.size() : p + 1);
+
+            const auto first = name.find_first_not_of(" \t\r\n");
+            if (first == std::string_view::npos) {
+                continue;
+            }
+            name = name.substr(first, name.find_last_not_of(" \t\r\n") - first + 1);
+            if (std::find(names.cbegin(), names.cend(), name) == names.cend()) {
+                names.emplace_back(name);
+            }
+        }
+        return names;
+    }
+
+    // Search of one index of FTS$SEARCH_MULTI.
+    struct IndexSearch
+    {
+        std::string indexName;
+        std::string relationName;
+        std::string keyFieldName;
+        String unicodeKeyFieldName;
+        RelationFieldInfo keyFieldInfo;
+        FTSSearcherPtr ftsSearcher;
+        QueryPtr query;
+        WeightPtr weight;
+        TopDocsPtr docs;
+    };
+
+    // Hit of FTS$SEARCH_MULTI.
+    struct IndexHit
+    {
+        double score;
+        size_t index;
+        int32_t doc;
+    };
+
+    // Scoring factors of a query term found in a document.
+    struct TermExplanation
+    {
+        String fieldName;
+        String text;
+        int32_t freq;
+        double tf;
+        double idf;
+        double fieldNorm;
+    };
+
+    // Computes the scoring factors of the query terms found in the document.
+    // The factors are read from the segment of the document, no explanation tree is built.
+    std::vector<TermExplanation> explainTerms(
+        const SearcherPtr& searcher,
+        const Collection<IndexReaderPtr>& segmentReaders,
+        const std::vector<int32_t>& docStarts,
+        const std::vector<TermPtr>& terms,
+        int32_t doc)
+    {
+        const auto segment = static_cast<size_t>(std::upper_bound(docStarts.cbegin(), docStarts.cend(), doc) - docStarts.cbegin()) - 1;
+        const auto& reader = segmentReaders[static_cast<int32_t>(segment)];
+        const int32_t segmentDoc = doc - docStarts[segment];
+        const auto similarity = searcher->getSimilarity();
+
+        std::vector<TermExplanation> explanations;
+        for (const auto& term : terms) {
+            int32_t freq = 0;
+            auto termDocs = reader->termDocs(term);
+            if (termDocs->skipTo(segmentDoc) && termDocs->doc() == segmentDoc) {
+                freq = termDocs->freq();
+            }
+            termDocs->close();
+            if (freq == 0) {
+                continue;
+            }
+            const auto norms = reader->norms(term->field());
+            explanations.push_back({
+                term->field(),
+                term->text(),
+                freq,
+                similarity->tf(freq),
+                similarity->idf(searcher->docFreq(term), searcher->maxDoc()),
+                norms ? Similarity::decodeNorm(norms[segmentDoc]) : 1.0
+            });
+        }
+        return explanations;
+    }
+
+    // number of the top hits collected by a warm-up query
+    constexpr int32_t WARMUP_QUERY_LIMIT = 100;
+
+    // Step of the index warm-up and its duration.
+    struct WarmupStep
+    {
+        std::string indexName;
+        std::string step;
+        std::string query;
+        double elapsedMs;
+    };
+
+    // Returns the milliseconds elapsed since the start and moves the start to the current time.
+    double lapMs(std::chrono::steady_clock::time_point& start)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const double elapsed = std::chrono::duration<double, std::milli>(now - start).count();
+        start = now;
+        return elapsed;
+    }
+
+    // Warms up the index after the server start: registers the searcher in the process cache,
+    // loads the norms and the key column and runs the warm-up queries of the index.
+    void warmupIndex(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        const std::string& databaseName,
+        FTSIndexRepository& indexRepository,
+        AnalyzerRepository& analyzerRepository,
+        RelationHelper& relationHelper,
+        const FTSIndex& ftsIndex,
+        const fs::path& indexDirectoryPath,
+        std::vector<WarmupStep>& steps)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        // the term index of each segment is loaded when the reader is opened
+        const auto ftsSearcher = FTSSearcherCache::instance().acquire(indexDirectoryPath, ftsIndex.storage);
+        if (!ftsSearcher) {
+            throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", ftsIndex.indexName.c_str());
+        }
+        steps.push_back({ ftsIndex.indexName, "OPEN", "", lapMs(start) });
+
+        for (const auto& segmentReader : ftsSearcher->segmentReaders()) {
+            for (const auto& fieldName : segmentReader->getFieldNames(IndexReader::FIELD_OPTION_INDEXED)) {
+                if (segmentReader->hasNorms(fieldName)) {
+                    segmentReader->norms(fieldName);
+                }
+            }
+        }
+        steps.push_back({ ftsIndex.indexName, "NORMS", "", lapMs(start) });
+
+        const auto iKeySegment = ftsIndex.findKey();
+        if (iKeySegment == ftsIndex.segments.cend()) {
+            throwException(status, R"(Not found key field in FTS index "%s".)", ftsIndex.indexName.c_str());
+        }
+        const auto keyFieldInfo = relationHelper.getField(status, att, tra, sqlDialect, ftsIndex.relationName, iKeySegment->fieldName());
+        ftsSearcher->preloadKeys(StringUtils::toUnicode(iKeySegment->fieldName()), keyFieldInfo.isInt());
+        steps.push_back({ ftsIndex.indexName, "KEYS", "", lapMs(start) });
+
+        const auto queries = indexRepository.getWarmupQueries(status, att, tra, sqlDialect, ftsIndex.indexName);
+        if (queries.empty()) {
+            return;
+        }
+        const auto analyzer = analyzerRepository.createAnalyzer(status, att, tra, sqlDialect, ftsIndex.analyzer);
+        const auto& searcher = ftsSearcher->searcher();
+        lapMs(start);
+        for (const auto& queryStr : queries) {
+            // the parsed query stays in the query cache for the following searches
+            auto query = parseQuery(databaseName, ftsIndex, analyzer, queryStr);
+            auto collector = TopScoreDocCollector::create(WARMUP_QUERY_LIMIT, false);
+            searcher->search(query, collector);
+            steps.push_back({ ftsIndex.indexName, "QUERY", queryStr, lapMs(start) });
+        }
+    }
+
+    // Writes the warm-up step to the output message of a warm-up procedure.
+    template <class Message>
+    void writeWarmupStep(Message* out, const WarmupStep& step)
+    {
+        out->stepNull = false;
+        out->step.length = static_cast<ISC_USHORT>(step.step.length());
+        step.step.copy(out->step.str, out->step.length);
+
+        out->queryNull = step.query.empty();
+        out->query.length = static_cast<ISC_USHORT>(step.query.length());
+        step.query.copy(out->query.str, out->query.length);
+
+        out->elapsedMsNull = false;
+        out->elapsedMs = step.elapsedMs;
+    }
+
+    // Net change of a record over the pending entries of the FTS log.
+    struct LogChange
+    {
+        std::string relationName;
+        bool dbKeyNull;
+        std::string dbKey;
+        bool uuidNull;
+        std::string uuid;
+        bool recIdNull;
+        ISC_INT64 recId;
+        char firstType; // type of the first change of the record
+        char lastType;  // type of the last change of the record
+    };
+
+    // Returns the key identifying the record of the change among the changes of the log.
+    std::string makeLogChangeKey(const LogChange& change)
+    {
+        std::string key = change.relationName;
+        key += '\0';
+        if (!change.dbKeyNull) {
+            key += static_cast<char>(change.dbKey.length());
+            key += change.dbKey;
+        }
+        key += '\0';
+        if (!change.uuidNull) {
+            key += static_cast<char>(change.uuid.length());
+            key += change.uuid;
+        }
+        key += '\0';
+        if (!change.recIdNull) {
+            key += std::to_string(change.recId);
+        }
+        return key;
+    }
+
+    // Returns the operation replacing all changes of the record:
+    // I - the document is added, U - the document is added or replaced, D - the document is deleted,
+    // empty - the index is not changed.
+    std::string_view netChangeType(const LogChange& change)
+    {
+        if (change.lastType == 'D') {
+            // a record inserted and deleted after the last update has never got into the index
+            return change.firstType == 'I' ? std::string_view() : std::string_view("D");
+        }
+        // a deleted and inserted again record replaces the old document
+        return change.firstType == 'I' ? std::string_view("I") : std::string_view("U");
+    }
 }
 
 /***
@@ -70,62 +591,960 @@ FB_UDR_BEGIN_FUNCTION(ftsEscapeQuery)
         (FB_INTL_VARCHAR(32765, CS_UTF8), query)
     );
 
-    FB_UDR_MESSAGE(OutMessage,
-        (FB_INTL_VARCHAR(32765, CS_UTF8), query)
-    );
+    FB_UDR_MESSAGE(OutMessage,
+        (FB_INTL_VARCHAR(32765, CS_UTF8), query)
+    );
+
+    FB_UDR_EXECUTE_FUNCTION
+    {
+        if (!in->queryNull) {
+            std::string_view queryStr(in->query.str, in->query.length);
+
+            const std::string escapedQuery = queryEscape(queryStr);
+
+            out->queryNull = false;
+            out->query.length = static_cast<ISC_USHORT>(escapedQuery.length());
+            escapedQuery.copy(out->query.str, out->query.length);
+        }
+        else {
+            out->queryNull = true;
+        }
+    }
+FB_UDR_END_FUNCTION
+
+/***
+PROCEDURE FTS$SEARCH (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$LIMIT INT NOT NULL DEFAULT 1000,
+    FTS$EXPLAIN BOOLEAN DEFAULT FALSE,
+    FTS$OFFSET INT NOT NULL DEFAULT 0,
+    FTS$AFTER_SCORE DOUBLE PRECISION DEFAULT NULL,
+    FTS$AFTER_DOC_ID INT DEFAULT NULL,
+    FTS$TIMEOUT_MS INT DEFAULT NULL,
+    FTS$MIN_SCORE DOUBLE PRECISION DEFAULT NULL,
+    FTS$SORT_FIELD VARCHAR(63) CHARACTER SET UTF8 DEFAULT NULL,
+    FTS$SORT_DESC BOOLEAN DEFAULT FALSE,
+    FTS$FILTER VARCHAR(8191) CHARACTER SET UTF8 DEFAULT NULL,
+    FTS$EXPLAIN_LIMIT INT DEFAULT NULL
+)
+RETURNS (
+    FTS$RELATION_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$KEY_FIELD_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$DB_KEY CHAR(8) CHARACTER SET OCTETS,
+    FTS$ID BIGINT,
+    FTS$UUID CHAR(16) CHARACTER SET OCTETS,
+    FTS$SCORE DOUBLE PRECISION,
+    FTS$EXPLANATION BLOB SUB_TYPE TEXT CHARACTER SET UTF8,
+    FTS$DOC_ID INT,
+    FTS$TRUNCATED BOOLEAN
+)
+EXTERNAL NAME 'luceneudr!ftsSearch'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(ftsSearch)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(32765, CS_UTF8), query)
+        (FB_INTEGER, limit)
+        (FB_BOOLEAN, explain)
+        (FB_INTEGER, offset)
+        (FB_DOUBLE, afterScore)
+        (FB_INTEGER, afterDocId)
+        (FB_INTEGER, timeoutMs)
+        (FB_DOUBLE, minScore)
+        (FB_INTL_VARCHAR(252, CS_UTF8), sortField)
+        (FB_BOOLEAN, sortDesc)
+        (FB_INTL_VARCHAR(32765, CS_UTF8), filter)
+        (FB_INTEGER, explainLimit)
+    );
+
+    FB_UDR_MESSAGE(OutMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), relationName)
+        (FB_INTL_VARCHAR(252, CS_UTF8), keyFieldName)
+        (FB_INTL_VARCHAR(8, CS_BINARY), dbKey)
+        (FB_BIGINT, id)
+        (FB_INTL_VARCHAR(16, CS_BINARY), uuid)
+        (FB_DOUBLE, score)
+        (FB_BLOB, explanation)
+        (FB_INTEGER, docId)
+        (FB_BOOLEAN, truncated)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+        , analyzerRepository(std::make_unique<AnalyzerRepository>(context->getMaster()))
+        , relationHelper(std::make_unique<RelationHelper>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository;
+    std::unique_ptr<AnalyzerRepository> analyzerRepository;
+    RelationHelperPtr relationHelper;
+
+    
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+    
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        if (in->indexNameNull) {
+            throwException(status, "Index name can not be NULL");
+        }
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+        
+        std::string queryStr;
+        if (!in->queryNull) {
+            queryStr.assign(in->query.str, in->query.length);
+        }
+
+        const auto limit = static_cast<int32_t>(in->limit);
+        const auto offset = in->offsetNull ? 0 : static_cast<int32_t>(in->offset);
+        if (limit < 0 || offset < 0) {
+            throwException(status, "FTS$LIMIT and FTS$OFFSET can not be negative");
+        }
+        if (offset > std::numeric_limits<int32_t>::max() - limit) {
+            throwException(status, "FTS$OFFSET is too large");
+        }
+        if (in->afterScoreNull != in->afterDocIdNull) {
+            throwException(status, "FTS$AFTER_SCORE and FTS$AFTER_DOC_ID must be specified together");
+        }
+        if (limit == 0 && !in->afterScoreNull) {
+            throwException(status, "The search cursor can not be used with FTS$LIMIT = 0");
+        }
+        const int64_t timeoutMs = in->timeoutMsNull ? 0 : in->timeoutMs;
+        if (!in->timeoutMsNull && timeoutMs <= 0) {
+            throwException(status, "FTS$TIMEOUT_MS must be greater than 0");
+        }
+        if (limit == 0 && timeoutMs > 0) {
+            throwException(status, "FTS$TIMEOUT_MS can not be used with FTS$LIMIT = 0");
+        }
+        const double minScore = in->minScoreNull ? std::numeric_limits<double>::lowest() : in->minScore;
+        std::string sortFieldName;
+        if (!in->sortFieldNull) {
+            sortFieldName.assign(in->sortField.str, in->sortField.length);
+        }
+        const bool sortDesc = !in->sortDescNull && in->sortDesc;
+        std::string filterStr;
+        if (!in->filterNull) {
+            filterStr.assign(in->filter.str, in->filter.length);
+        }
+        if (!sortFieldName.empty() && limit == 0) {
+            throwException(status, "FTS$SORT_FIELD can not be used with FTS$LIMIT = 0");
+        }
+        if (!sortFieldName.empty() && !in->afterScoreNull) {
+            throwException(status, "The search cursor can not be used with FTS$SORT_FIELD");
+        }
+
+        if (!in->explainNull) {
+            explainFlag = in->explain;
+        }
+        if (!in->explainLimitNull) {
+            if (in->explainLimit < 0) {
+                throwException(status, "FTS$EXPLAIN_LIMIT can not be negative");
+            }
+            explainLimit = in->explainLimit;
+        }
+
+        const auto ftsDirectoryPath = getFtsDirectory(status, context);
+
+        att.reset(context->getAttachment(status));
+        tra.reset(context->getTransaction(status));
+
+        unsigned int sqlDialect = getSqlDialect(status, att);
+
+        auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
+
+        // check if directory exists for index
+        const auto indexDirectoryPath = ftsDirectoryPath / indexName;
+        if (ftsIndex.status == "N" || !fs::is_directory(indexDirectoryPath)) {
+            std::string sIndexName(indexName);
+            throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", sIndexName.c_str());
+        }
+
+        try {
+            ftsSearcher = FTSSearcherCache::instance().acquire(indexDirectoryPath, ftsIndex.storage);
+            if (!ftsSearcher) {
+                std::string sIndexName(indexName);
+                throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", sIndexName.c_str());
+            }
+
+            AnalyzerPtr analyzer = procedure->analyzerRepository->createAnalyzer(status, att, tra, sqlDialect, ftsIndex.analyzer);
+            searcher = ftsSearcher->searcher();
+            
+            std::string keyFieldName;
+            const auto iKeySegment = ftsIndex.findKey();
+            if (iKeySegment != ftsIndex.segments.cend()) {
+                keyFieldName = iKeySegment->fieldName();
+            }
+            if (keyFieldName.empty()) {
+                std::string sIndexName(indexName);
+                throwException(status, R"(Not found key field in FTS index "%s".)", sIndexName.c_str());
+            }
+            unicodeKeyFieldName = StringUtils::toUnicode(keyFieldName);
+
+            keyFieldInfo = procedure->relationHelper->getField(status, att, tra, sqlDialect, ftsIndex.relationName, keyFieldName);
+
+            SortPtr sort;
+            if (!sortFieldName.empty()) {
+                const auto iSortSegment = ftsIndex.findSegment(sortFieldName);
+                if (iSortSegment == ftsIndex.segments.cend()) {
+                    std::string sIndexName(indexName);
+                    throwException(status, R"(Field "%s" not exists in index "%s")", sortFieldName.c_str(), sIndexName.c_str());
+                }
+                if (!iSortSegment->isSortable()) {
+                    std::string sIndexName(indexName);
+                    throwException(status, R"(Field "%s" of index "%s" is not sortable)", sortFieldName.c_str(), sIndexName.c_str());
+                }
+                const auto sortFieldInfo = procedure->relationHelper->getField(status, att, tra, sqlDialect, ftsIndex.relationName, sortFieldName);
+                sort = makeSort(sortFieldName, getSortType(sortFieldInfo), sortDesc);
+            }
+
+            query = parseQuery(context->getDatabaseName(), ftsIndex, analyzer, queryStr);
+
+            // the filter skips the documents before they are scored
+            QueryPtr searchQuery = query;
+            if (auto filter = makeFilter(status, att, tra, sqlDialect, *procedure->relationHelper, ftsIndex, indexDirectoryPath, ftsSearcher, filterStr)) {
+                searchQuery = newLucene<FilteredQuery>(query, filter);
+            }
+
+            // identical searches over the same index snapshot are served from the result cache
+            auto& resultCache = FTSResultCache::instance();
+            std::string searchKey;
+            if (limit > 0) {
+                searchKey = makeSearchKey(queryStr, filterStr, offset, limit, minScore, sortFieldName, sortDesc,
+                    in->afterScoreNull, in->afterScore, in->afterDocId);
+                docs = resultCache.get(indexDirectoryPath, searchKey, ftsSearcher, query);
+            }
+            const bool cached = static_cast<bool>(docs);
+            bool truncated = false;
+
+            if (cached) {
+                // nothing is scored
+            }
+            else if (limit == 0) {
+                // stream all hits in index order, nothing is queued
+                hitStream = std::make_unique<FTSHitStream>(searcher, searchQuery, ftsSearcher->segmentReaders(), ftsSearcher->docStarts(), minScore);
+                for (int32_t i = 0; i < offset && hitStream->next(); i++) {
+                    // skip the hits before the page
+                }
+            }
+            else if (sort) {
+                // the queue is ordered by the field value, scores are only tracked for the output
+                auto collector = TopFieldCollector::create(sort, offset + limit, false, true, false, false);
+                truncated = !collectHits(searcher, searchQuery, collector, minScore, timeoutMs);
+                docs = collector->topDocs(offset, limit);
+            }
+            else if (ftsIndex.parallelism > 1 && ftsSearcher->segmentReaders().size() > 1) {
+                // groups of segments are searched on the worker pool, each group keeps its own queue
+                const auto& segmentReaders = ftsSearcher->segmentReaders();
+                const auto& docStarts = ftsSearcher->docStarts();
+                const auto parallelism = static_cast<size_t>(ftsIndex.parallelism);
+                if (in->afterScoreNull) {
+                    docs = parallelSearch(searcher, searchQuery, segmentReaders, docStarts, parallelism, offset, limit, minScore, timeoutMs, truncated,
+                        [numHits = offset + limit]() {
+                            return TopScoreDocCollector::create(numHits, false);
+                        });
+                }
+                else {
+                    docs = parallelSearch(searcher, searchQuery, segmentReaders, docStarts, parallelism, offset, limit, minScore, timeoutMs, truncated,
+                        [numHits = offset + limit, afterScore = in->afterScore, afterDocId = in->afterDocId]() {
+                            return newLucene<SearchAfterCollector>(numHits, afterScore, afterDocId);
+                        });
+                }
+            }
+            else if (in->afterScoreNull) {
+                // page by offset, the queue holds all hits up to the end of the page
+                auto collector = TopScoreDocCollector::create(offset + limit, false);
+                truncated = !collectHits(searcher, searchQuery, collector, minScore, timeoutMs);
+                docs = collector->topDocs(offset, limit);
+            }
+            else {
+                // page by cursor, the queue holds only the hits of the page
+                auto collector = newLucene<SearchAfterCollector>(offset + limit, in->afterScore, in->afterDocId);
+                truncated = !collectHits(searcher, searchQuery, collector, minScore, timeoutMs);
+                docs = collector->topDocs(offset, limit);
+            }
+            if (docs) {
+                if (!cached && !truncated) {
+                    // partial results are not cached
+                    resultCache.put(indexDirectoryPath, searchKey, ftsSearcher, query, docs);
+                }
+                it = docs->scoreDocs.begin();
+            }
+
+            out->relationNameNull = false;
+            out->relationName.length = static_cast<ISC_USHORT>(ftsIndex.relationName.length());
+            ftsIndex.relationName.copy(out->relationName.str, out->relationName.length);
+
+            out->keyFieldNameNull = false;
+            out->keyFieldName.length = static_cast<ISC_USHORT>(keyFieldName.length());
+            keyFieldName.copy(out->keyFieldName.str, out->keyFieldName.length);
+
+            out->dbKeyNull = true;
+            out->uuidNull = true;
+            out->idNull = true;
+            out->scoreNull = true;
+            out->docIdNull = true;
+
+            out->truncatedNull = false;
+            out->truncated = truncated;
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+    }
+
+    bool explainFlag = false;
+    int64_t explainLimit = -1; // number of the first rows with the explanation, -1 - all rows
+    int64_t explainedCount = 0;
+    AutoRelease<IAttachment> att;
+    AutoRelease<ITransaction> tra;
+    RelationFieldInfo keyFieldInfo;
+    String unicodeKeyFieldName;
+    FTSSearcherPtr ftsSearcher;
+    SearcherPtr searcher;
+    QueryPtr query;
+    TopDocsPtr docs;
+    Collection<ScoreDocPtr>::iterator it;
+    std::unique_ptr<FTSHitStream> hitStream;
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        try {
+            int32_t doc;
+            double score;
+            if (hitStream) {
+                if (!hitStream->next()) {
+                    return false;
+                }
+                doc = hitStream->doc();
+                score = hitStream->score();
+            }
+            else {
+                if (it == docs->scoreDocs.end()) {
+                    return false;
+                }
+                doc = (*it)->doc;
+                score = (*it)->score;
+                ++it;
+            }
+
+            writeKey(status, out, *ftsSearcher, unicodeKeyFieldName, keyFieldInfo, doc);
+
+            out->scoreNull = false;
+            out->score = score;
+
+            out->docIdNull = false;
+            out->docId = doc;
+
+            if (explainFlag && (explainLimit < 0 || explainedCount < explainLimit)) {
+                // each explanation is a temporary BLOB, so only the first rows are explained
+                auto explanation = searcher->explain(query, doc);
+                const std::string explanationStr = StringUtils::toUTF8(explanation->toString());
+                out->explanationNull = false;
+                writeStringToBlob(status, att, tra, &out->explanation, explanationStr);
+                ++explainedCount;
+            }
+            else {
+                out->explanationNull = true;
+            }
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+        return true;
+    }
+FB_UDR_END_PROCEDURE
+
+/***
+PROCEDURE FTS$SEARCH_COUNT (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8
+)
+RETURNS (
+    FTS$COUNT INTEGER
+)
+EXTERNAL NAME 'luceneudr!ftsSearchCount'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(ftsSearchCount)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(32765, CS_UTF8), query)
+    );
+
+    FB_UDR_MESSAGE(OutMessage,
+        (FB_INTEGER, count)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+        , analyzerRepository(std::make_unique<AnalyzerRepository>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository;
+    std::unique_ptr<AnalyzerRepository> analyzerRepository;
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        if (in->indexNameNull) {
+            throwException(status, "Index name can not be NULL");
+        }
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+
+        std::string queryStr;
+        if (!in->queryNull) {
+            queryStr.assign(in->query.str, in->query.length);
+        }
+
+        const auto ftsDirectoryPath = getFtsDirectory(status, context);
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        unsigned int sqlDialect = getSqlDialect(status, att);
+
+        auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
+
+        // check if directory exists for index
+        const auto indexDirectoryPath = ftsDirectoryPath / indexName;
+        if (ftsIndex.status == "N" || !fs::is_directory(indexDirectoryPath)) {
+            std::string sIndexName(indexName);
+            throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", sIndexName.c_str());
+        }
+
+        try {
+            auto ftsSearcher = FTSSearcherCache::instance().acquire(indexDirectoryPath, ftsIndex.storage);
+            if (!ftsSearcher) {
+                std::string sIndexName(indexName);
+                throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", sIndexName.c_str());
+            }
+
+            AnalyzerPtr analyzer = procedure->analyzerRepository->createAnalyzer(status, att, tra, sqlDialect, ftsIndex.analyzer);
+            auto query = parseQuery(context->getDatabaseName(), ftsIndex, analyzer, queryStr);
+
+            // neither scores nor keys are needed to count the hits
+            auto collector = newLucene<HitCountCollector>();
+            ftsSearcher->searcher()->search(query, collector);
+
+            out->countNull = false;
+            out->count = collector->getTotalHits();
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+    }
+
+    bool fetched = false;
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        if (fetched) {
+            return false;
+        }
+        fetched = !fetched;
+        return true;
+    }
+FB_UDR_END_PROCEDURE
+
+/***
+PROCEDURE FTS$SEARCH_EXPLAIN (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$LIMIT INT NOT NULL DEFAULT 10
+)
+RETURNS (
+    FTS$DB_KEY CHAR(8) CHARACTER SET OCTETS,
+    FTS$ID BIGINT,
+    FTS$UUID CHAR(16) CHARACTER SET OCTETS,
+    FTS$DOC_ID INT,
+    FTS$SCORE DOUBLE PRECISION,
+    FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$TERM VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$FREQ INT,
+    FTS$TF DOUBLE PRECISION,
+    FTS$IDF DOUBLE PRECISION,
+    FTS$FIELD_NORM DOUBLE PRECISION,
+    FTS$COORD DOUBLE PRECISION
+)
+EXTERNAL NAME 'luceneudr!ftsSearchExplain'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(ftsSearchExplain)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(32765, CS_UTF8), query)
+        (FB_INTEGER, limit)
+    );
+
+    FB_UDR_MESSAGE(OutMessage,
+        (FB_INTL_VARCHAR(8, CS_BINARY), dbKey)
+        (FB_BIGINT, id)
+        (FB_INTL_VARCHAR(16, CS_BINARY), uuid)
+        (FB_INTEGER, docId)
+        (FB_DOUBLE, score)
+        (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
+        (FB_INTL_VARCHAR(32765, CS_UTF8), term)
+        (FB_INTEGER, freq)
+        (FB_DOUBLE, tf)
+        (FB_DOUBLE, idf)
+        (FB_DOUBLE, fieldNorm)
+        (FB_DOUBLE, coord)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+        , analyzerRepository(std::make_unique<AnalyzerRepository>(context->getMaster()))
+        , relationHelper(std::make_unique<RelationHelper>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository;
+    std::unique_ptr<AnalyzerRepository> analyzerRepository;
+    RelationHelperPtr relationHelper;
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        if (in->indexNameNull) {
+            throwException(status, "Index name can not be NULL");
+        }
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+
+        std::string queryStr;
+        if (!in->queryNull) {
+            queryStr.assign(in->query.str, in->query.length);
+        }
+
+        const auto limit = static_cast<int32_t>(in->limit);
+        if (limit <= 0) {
+            throwException(status, "FTS$LIMIT must be greater than 0");
+        }
+
+        const auto ftsDirectoryPath = getFtsDirectory(status, context);
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        unsigned int sqlDialect = getSqlDialect(status, att);
+
+        auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
+
+        // check if directory exists for index
+        const auto indexDirectoryPath = ftsDirectoryPath / indexName;
+        if (ftsIndex.status == "N" || !fs::is_directory(indexDirectoryPath)) {
+            std::string sIndexName(indexName);
+            throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", sIndexName.c_str());
+        }
+
+        try {
+            ftsSearcher = FTSSearcherCache::instance().acquire(indexDirectoryPath, ftsIndex.storage);
+            if (!ftsSearcher) {
+                std::string sIndexName(indexName);
+                throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", sIndexName.c_str());
+            }
+
+            AnalyzerPtr analyzer = procedure->analyzerRepository->createAnalyzer(status, att, tra, sqlDialect, ftsIndex.analyzer);
+            searcher = ftsSearcher->searcher();
+
+            const auto iKeySegment = ftsIndex.findKey();
+            if (iKeySegment == ftsIndex.segments.cend()) {
+                std::string sIndexName(indexName);
+                throwException(status, R"(Not found key field in FTS index "%s".)", sIndexName.c_str());
+            }
+            unicodeKeyFieldName = StringUtils::toUnicode(iKeySegment->fieldName());
+            keyFieldInfo = procedure->relationHelper->getField(status, att, tra, sqlDialect, ftsIndex.relationName, iKeySegment->fieldName());
+
+            auto query = parseQuery(context->getDatabaseName(), ftsIndex, analyzer, queryStr);
+
+            // the terms of wildcard and fuzzy queries are known only after the rewrite
+            auto termSet = SetTerm::newInstance();
+            searcher->rewrite(query)->extractTerms(termSet);
+            terms.assign(termSet.begin(), termSet.end());
+
+            auto collector = TopScoreDocCollector::create(limit, false);
+            searcher->search(query, collector);
+            docs = collector->topDocs();
+            it = docs->scoreDocs.begin();
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+    }
+
+    RelationFieldInfo keyFieldInfo;
+    String unicodeKeyFieldName;
+    FTSSearcherPtr ftsSearcher;
+    SearcherPtr searcher;
+    std::vector<TermPtr> terms;
+    TopDocsPtr docs;
+    Collection<ScoreDocPtr>::iterator it;
+    std::vector<TermExplanation> explanations;
+    size_t explanationIndex = 0;
+    double coord = 0.0;
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        try {
+            if (explanationIndex >= explanations.size()) {
+                // the current hit is done, the first row of the next hit is written
+                if (it == docs->scoreDocs.end()) {
+                    return false;
+                }
+                const int32_t doc = (*it)->doc;
+                explanations = explainTerms(searcher, ftsSearcher->segmentReaders(), ftsSearcher->docStarts(), terms, doc);
+                explanationIndex = 0;
+                coord = searcher->getSimilarity()->coord(static_cast<int32_t>(explanations.size()), static_cast<int32_t>(terms.size()));
+
+                writeKey(status, out, *ftsSearcher, unicodeKeyFieldName, keyFieldInfo, doc);
+
+                out->docIdNull = false;
+                out->docId = doc;
+
+                out->scoreNull = false;
+                out->score = (*it)->score;
+
+                out->coordNull = false;
+                out->coord = coord;
+
+                ++it;
+            }
+
+            if (explanations.empty()) {
+                // none of the extracted terms is found, for example, the hit of a constant score query
+                out->fieldNameNull = true;
+                out->termNull = true;
+                out->freqNull = true;
+                out->tfNull = true;
+                out->idfNull = true;
+                out->fieldNormNull = true;
+                return true;
+            }
+
+            const auto& explanation = explanations[explanationIndex++];
+
+            const std::string fieldName = StringUtils::toUTF8(explanation.fieldName);
+            out->fieldNameNull = false;
+            out->fieldName.length = static_cast<ISC_USHORT>(fieldName.length());
+            fieldName.copy(out->fieldName.str, out->fieldName.length);
+
+            const std::string termText = StringUtils::toUTF8(explanation.text);
+            out->termNull = false;
+            out->term.length = static_cast<ISC_USHORT>(std::min<size_t>(termText.length(), 32765));
+            termText.copy(out->term.str, out->term.length);
+
+            out->freqNull = false;
+            out->freq = explanation.freq;
+
+            out->tfNull = false;
+            out->tf = explanation.tf;
+
+            out->idfNull = false;
+            out->idf = explanation.idf;
+
+            out->fieldNormNull = false;
+            out->fieldNorm = explanation.fieldNorm;
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+        return true;
+    }
+FB_UDR_END_PROCEDURE
+
+/***
+PROCEDURE FTS$SEARCH_MULTI (
+    FTS$INDEX_NAMES VARCHAR(8191) CHARACTER SET UTF8 NOT NULL,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$LIMIT INT NOT NULL DEFAULT 1000,
+    FTS$EXPLAIN BOOLEAN DEFAULT FALSE,
+    FTS$EXPLAIN_LIMIT INT DEFAULT NULL
+)
+RETURNS (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$RELATION_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$KEY_FIELD_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$DB_KEY CHAR(8) CHARACTER SET OCTETS,
+    FTS$ID BIGINT,
+    FTS$UUID CHAR(16) CHARACTER SET OCTETS,
+    FTS$SCORE DOUBLE PRECISION,
+    FTS$EXPLANATION BLOB SUB_TYPE TEXT CHARACTER SET UTF8
+)
+EXTERNAL NAME 'luceneudr!ftsSearchMulti'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(ftsSearchMulti)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(32765, CS_UTF8), indexNames)
+        (FB_INTL_VARCHAR(32765, CS_UTF8), query)
+        (FB_INTEGER, limit)
+        (FB_BOOLEAN, explain)
+        (FB_INTEGER, explainLimit)
+    );
+
+    FB_UDR_MESSAGE(OutMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(252, CS_UTF8), relationName)
+        (FB_INTL_VARCHAR(252, CS_UTF8), keyFieldName)
+        (FB_INTL_VARCHAR(8, CS_BINARY), dbKey)
+        (FB_BIGINT, id)
+        (FB_INTL_VARCHAR(16, CS_BINARY), uuid)
+        (FB_DOUBLE, score)
+        (FB_BLOB, explanation)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+        , analyzerRepository(std::make_unique<AnalyzerRepository>(context->getMaster()))
+        , relationHelper(std::make_unique<RelationHelper>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository;
+    std::unique_ptr<AnalyzerRepository> analyzerRepository;
+    RelationHelperPtr relationHelper;
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        if (in->indexNamesNull) {
+            throwException(status, "Index names can not be NULL");
+        }
+        const auto indexNames = splitIndexNames(std::string_view(in->indexNames.str, in->indexNames.length));
+        if (indexNames.empty()) {
+            throwException(status, "The list of index names is empty");
+        }
+
+        std::string queryStr;
+        if (!in->queryNull) {
+            queryStr.assign(in->query.str, in->query.length);
+        }
+
+        const auto limit = static_cast<int32_t>(in->limit);
+        if (limit <= 0) {
+            throwException(status, "FTS$LIMIT must be greater than 0");
+        }
+
+        if (!in->explainNull) {
+            explainFlag = in->explain;
+        }
+        if (!in->explainLimitNull) {
+            if (in->explainLimit < 0) {
+                throwException(status, "FTS$EXPLAIN_LIMIT can not be negative");
+            }
+            explainLimit = in->explainLimit;
+        }
+
+        const auto ftsDirectoryPath = getFtsDirectory(status, context);
+
+        att.reset(context->getAttachment(status));
+        tra.reset(context->getTransaction(status));
+
+        unsigned int sqlDialect = getSqlDialect(status, att);
+
+        try {
+            // Firebird interfaces are used only by this thread,
+            // so the indexes are opened and the queries are parsed before the searches start.
+            searches.reserve(indexNames.size());
+            for (const auto& indexName : indexNames) {
+                auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
+                // the same index listed twice would return every hit twice
+                const auto isSameIndex = [&ftsIndex](const IndexSearch& search) { return search.indexName == ftsIndex.indexName; };
+                if (std::any_of(searches.cbegin(), searches.cend(), isSameIndex)) {
+                    continue;
+                }
+
+                // check if directory exists for index
+                const auto indexDirectoryPath = ftsDirectoryPath / indexName;
+                if (ftsIndex.status == "N" || !fs::is_directory(indexDirectoryPath)) {
+                    throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", indexName.c_str());
+                }
+
+                auto& search = searches.emplace_back();
+                search.indexName = ftsIndex.indexName;
+                search.relationName = ftsIndex.relationName;
+
+                search.ftsSearcher = FTSSearcherCache::instance().acquire(indexDirectoryPath, ftsIndex.storage);
+                if (!search.ftsSearcher) {
+                    throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", indexName.c_str());
+                }
+
+                const auto iKeySegment = ftsIndex.findKey();
+                if (iKeySegment != ftsIndex.segments.cend()) {
+                    search.keyFieldName = iKeySegment->fieldName();
+                }
+                if (search.keyFieldName.empty()) {
+                    throwException(status, R"(Not found key field in FTS index "%s".)", indexName.c_str());
+                }
+                search.unicodeKeyFieldName = StringUtils::toUnicode(search.keyFieldName);
+                search.keyFieldInfo = procedure->relationHelper->getField(status, att, tra, sqlDialect, ftsIndex.relationName, search.keyFieldName);
+
+                AnalyzerPtr analyzer = procedure->analyzerRepository->createAnalyzer(status, att, tra, sqlDialect, ftsIndex.analyzer);
+                search.query = parseQuery(context->getDatabaseName(), ftsIndex, analyzer, queryStr);
+            }
+
+            // Each query is rewritten against its own index, but weighted with the document frequencies
+            // and the number of documents of all indexes, so the scores of different indexes are comparable.
+            auto searchers = Collection<SearcherPtr>::newInstance();
+            for (const auto& search : searches) {
+                searchers.add(search.ftsSearcher->searcher());
+            }
+            auto dfSource = newLucene<AggregatedDfSource>(searchers);
+            for (auto& search : searches) {
+                search.query = search.ftsSearcher->searcher()->rewrite(search.query);
+                search.weight = search.query->weight(dfSource);
+            }
+
+            // search all indexes in parallel, each index gives at most limit hits
+            WorkerPool::Batch batch(WorkerPool::instance());
+            std::vector<std::future<TopDocsPtr>> futures;
+            futures.reserve(searches.size());
+            for (const auto& search : searches) {
+                futures.push_back(batch.submit([searcher = search.ftsSearcher->searcher(), weight = search.weight, limit]() {
+                    return searcher->search(weight, FilterPtr(), limit);
+                }));
+            }
+            for (size_t i = 0; i < searches.size(); i++) {
+                searches[i].docs = batch.wait(futures[i]);
+            }
+
+            // merge the hits of all indexes into one ranking
+            for (size_t i = 0; i < searches.size(); i++) {
+                for (const auto& scoreDoc : searches[i].docs->scoreDocs) {
+                    hits.push_back({ scoreDoc->score, i, scoreDoc->doc });
+                }
+            }
+            std::sort(hits.begin(), hits.end(), [](const IndexHit& a, const IndexHit& b) {
+                if (a.score != b.score) {
+                    return a.score > b.score;
+                }
+                if (a.index != b.index) {
+                    return a.index < b.index;
+                }
+                return a.doc < b.doc;
+            });
+            if (hits.size() > static_cast<size_t>(limit)) {
+                hits.resize(static_cast<size_t>(limit));
+            }
+            it = hits.cbegin();
+
+            out->scoreNull = true;
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+    }
 
-    FB_UDR_EXECUTE_FUNCTION
+    bool explainFlag = false;
+    int64_t explainLimit = -1; // number of the first rows with the explanation, -1 - all rows
+    int64_t explainedCount = 0;
+    AutoRelease<IAttachment> att;
+    AutoRelease<ITransaction> tra;
+    std::vector<IndexSearch> searches;
+    std::vector<IndexHit> hits;
+    std::vector<IndexHit>::const_iterator it;
+
+    FB_UDR_FETCH_PROCEDURE
     {
-        if (!in->queryNull) {
-            std::string_view queryStr(in->query.str, in->query.length);
+        if (it == hits.cend()) {
+            return false;
+        }
+        const auto& hit = *it;
+        ++it;
+        const auto& search = searches[hit.index];
+        try {
+            out->indexNameNull = false;
+            out->indexName.length = static_cast<ISC_USHORT>(search.indexName.length());
+            search.indexName.copy(out->indexName.str, out->indexName.length);
 
-            const std::string escapedQuery = queryEscape(queryStr);
+            out->relationNameNull = false;
+            out->relationName.length = static_cast<ISC_USHORT>(search.relationName.length());
+            search.relationName.copy(out->relationName.str, out->relationName.length);
 
-            out->queryNull = false;
-            out->query.length = static_cast<ISC_USHORT>(escapedQuery.length());
-            escapedQuery.copy(out->query.str, out->query.length);
+            out->keyFieldNameNull = false;
+            out->keyFieldName.length = static_cast<ISC_USHORT>(search.keyFieldName.length());
+            search.keyFieldName.copy(out->keyFieldName.str, out->keyFieldName.length);
+
+            writeKey(status, out, *search.ftsSearcher, search.unicodeKeyFieldName, search.keyFieldInfo, hit.doc);
+
+            out->scoreNull = false;
+            out->score = hit.score;
+
+            if (explainFlag && (explainLimit < 0 || explainedCount < explainLimit)) {
+                auto explanation = search.ftsSearcher->searcher()->explain(search.weight, hit.doc);
+                const std::string explanationStr = StringUtils::toUTF8(explanation->toString());
+                out->explanationNull = false;
+                writeStringToBlob(status, att, tra, &out->explanation, explanationStr);
+                ++explainedCount;
+            }
+            else {
+                out->explanationNull = true;
+            }
         }
-        else {
-            out->queryNull = true;
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
         }
+        return true;
     }
-FB_UDR_END_FUNCTION
+FB_UDR_END_PROCEDURE
 
 /***
-PROCEDURE FTS$SEARCH (
-    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
-    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
-    FTS$LIMIT INT NOT NULL DEFAULT 1000,
-    FTS$EXPLAIN BOOLEAN DEFAULT FALSE
+PROCEDURE FTS$WARMUP_INDEX (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL
 )
 RETURNS (
-    FTS$RELATION_NAME VARCHAR(63) CHARACTER SET UTF8,
-    FTS$KEY_FIELD_NAME VARCHAR(63) CHARACTER SET UTF8,
-    FTS$DB_KEY CHAR(8) CHARACTER SET OCTETS,
-    FTS$ID BIGINT,
-    FTS$UUID CHAR(16) CHARACTER SET OCTETS,
-    FTS$SCORE DOUBLE PRECISION,
-    FTS$EXPLANATION BLOB SUB_TYPE TEXT CHARACTER SET UTF8
+    FTS$STEP VARCHAR(10) CHARACTER SET UTF8,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$ELAPSED_MS DOUBLE PRECISION
 )
-EXTERNAL NAME 'luceneudr!ftsSearch'
+EXTERNAL NAME 'luceneudr!ftsWarmupIndex'
 ENGINE UDR;
 ***/
-FB_UDR_BEGIN_PROCEDURE(ftsSearch)
+FB_UDR_BEGIN_PROCEDURE(ftsWarmupIndex)
     FB_UDR_MESSAGE(InMessage,
         (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
-        (FB_INTL_VARCHAR(32765, CS_UTF8), query)
-        (FB_INTEGER, limit)
-        (FB_BOOLEAN, explain)
     );
 
     FB_UDR_MESSAGE(OutMessage,
-        (FB_INTL_VARCHAR(252, CS_UTF8), relationName)
-        (FB_INTL_VARCHAR(252, CS_UTF8), keyFieldName)
-        (FB_INTL_VARCHAR(8, CS_BINARY), dbKey)
-        (FB_BIGINT, id)
-        (FB_INTL_VARCHAR(16, CS_BINARY), uuid)
-        (FB_DOUBLE, score)
-        (FB_BLOB, explanation)
+        (FB_INTL_VARCHAR(40, CS_UTF8), step)
+        (FB_INTL_VARCHAR(32765, CS_UTF8), query)
+        (FB_DOUBLE, elapsedMs)
     );
 
     FB_UDR_CONSTRUCTOR
@@ -139,7 +1558,6 @@ FB_UDR_BEGIN_PROCEDURE(ftsSearch)
     std::unique_ptr<AnalyzerRepository> analyzerRepository;
     RelationHelperPtr relationHelper;
 
-    
     void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
         char* name, unsigned nameSize)
     {
@@ -147,33 +1565,22 @@ FB_UDR_BEGIN_PROCEDURE(ftsSearch)
         memset(name, 0, nameSize);
         memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
     }
-    
+
     FB_UDR_EXECUTE_PROCEDURE
     {
         if (in->indexNameNull) {
             throwException(status, "Index name can not be NULL");
         }
         std::string_view indexName(in->indexName.str, in->indexName.length);
-        
-        std::string queryStr;
-        if (!in->queryNull) {
-            queryStr.assign(in->query.str, in->query.length);
-        }
-
-        const auto limit = static_cast<int32_t>(in->limit);
-
-        if (!in->explainNull) {
-            explainFlag = in->explain;
-        }
 
         const auto ftsDirectoryPath = getFtsDirectory(status, context);
 
-        att.reset(context->getAttachment(status));
-        tra.reset(context->getTransaction(status));
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
 
         unsigned int sqlDialect = getSqlDialect(status, att);
 
-        auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
+        const auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
 
         // check if directory exists for index
         const auto indexDirectoryPath = ftsDirectoryPath / indexName;
@@ -183,134 +1590,113 @@ FB_UDR_BEGIN_PROCEDURE(ftsSearch)
         }
 
         try {
-            auto ftsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
-            if (!IndexReader::indexExists(ftsIndexDir)) {
-                std::string sIndexName(indexName);
-                throwException(status, R"(Index "%s" exists, but is not build. Please rebuild index.)", sIndexName.c_str());
-            }
-
-            AnalyzerPtr analyzer = procedure->analyzerRepository->createAnalyzer(status, att, tra, sqlDialect, ftsIndex.analyzer);
-            searcher = newLucene<IndexSearcher>(ftsIndexDir, true);
-            
-            std::string keyFieldName;
-            auto fields = Collection<String>::newInstance();
-            for (const auto& segment : ftsIndex.segments) {
-                if (!segment.isKey()) {
-                    fields.add(StringUtils::toUnicode(segment.fieldName()));
-                }
-                else {
-                    keyFieldName = segment.fieldName();
-                }
-            }
-            if (keyFieldName.empty()) {
-                std::string sIndexName(indexName);
-                throwException(status, R"(Not found key field in FTS index "%s".)", sIndexName.c_str());
-            }
-            unicodeKeyFieldName = StringUtils::toUnicode(keyFieldName);
-
-            keyFieldInfo = procedure->relationHelper->getField(status, att, tra, sqlDialect, ftsIndex.relationName, keyFieldName);
-
-            if (fields.size() == 1) {
-                QueryParserPtr parser = newLucene<QueryParser>(LuceneVersion::LUCENE_CURRENT, fields[0], analyzer);
-                query = parser->parse(StringUtils::toUnicode(queryStr));
-            }
-            else {
-                MultiFieldQueryParserPtr  parser = newLucene<MultiFieldQueryParser>(LuceneVersion::LUCENE_CURRENT, fields, analyzer);
-                parser->setDefaultOperator(QueryParser::OR_OPERATOR);
-                query = parser->parse(StringUtils::toUnicode(queryStr));
-            }
-            docs = searcher->search(query, limit);
-
-            it = docs->scoreDocs.begin();
-
-            out->relationNameNull = false;
-            out->relationName.length = static_cast<ISC_USHORT>(ftsIndex.relationName.length());
-            ftsIndex.relationName.copy(out->relationName.str, out->relationName.length);
-
-            out->keyFieldNameNull = false;
-            out->keyFieldName.length = static_cast<ISC_USHORT>(keyFieldName.length());
-            keyFieldName.copy(out->keyFieldName.str, out->keyFieldName.length);
-
-            out->dbKeyNull = true;
-            out->uuidNull = true;
-            out->idNull = true;
-            out->scoreNull = true;
+            warmupIndex(status, att, tra, sqlDialect, context->getDatabaseName(),
+                *procedure->indexRepository, *procedure->analyzerRepository, *procedure->relationHelper,
+                ftsIndex, indexDirectoryPath, steps);
         }
         catch (const LuceneException& e) {
             const std::string error_message = StringUtils::toUTF8(e.getError());
             throwException(status, error_message.c_str());
         }
+        it = steps.cbegin();
     }
 
-    bool explainFlag = false;
-    AutoRelease<IAttachment> att;
-    AutoRelease<ITransaction> tra;
-    RelationFieldInfo keyFieldInfo;
-    String unicodeKeyFieldName;
-    SearcherPtr searcher;
-    QueryPtr query;
-    TopDocsPtr docs;
-    Collection<ScoreDocPtr>::iterator it;
+    std::vector<WarmupStep> steps;
+    std::vector<WarmupStep>::const_iterator it;
 
     FB_UDR_FETCH_PROCEDURE
     {
-        try {
-            if (it == docs->scoreDocs.end()) {
-                return false;
-            }
-            ScoreDocPtr scoreDoc = *it;
-            DocumentPtr doc = searcher->doc(scoreDoc->doc);
+        if (it == steps.cend()) {
+            return false;
+        }
+        writeWarmupStep(out, *it);
+        ++it;
+        return true;
+    }
+FB_UDR_END_PROCEDURE
 
-            try {
-                const std::string keyValue = StringUtils::toUTF8(doc->get(unicodeKeyFieldName));
-                if (keyFieldInfo.isDbKey()) {
-                    // In the Lucene index, the string is stored in hexadecimal form, so let's convert it back to binary format.
-                    auto dbKey = hex_to_binary(keyValue);
-                    std::string_view svDbKey(reinterpret_cast<char*>(dbKey.data()), dbKey.size());
-                    out->dbKeyNull = false;
-                    out->dbKey.length = static_cast<ISC_USHORT>(svDbKey.size());
-                    svDbKey.copy(out->dbKey.str, out->dbKey.length);
-                }
-                else if (keyFieldInfo.isBinary()) {
-                    // In the Lucene index, the string is stored in hexadecimal form, so let's convert it back to binary format.
-                    auto uuid = hex_to_binary(keyValue);
-                    std::string_view svUuid(reinterpret_cast<char*>(uuid.data()), uuid.size());
-                    out->uuidNull = false;
-                    out->uuid.length = static_cast<ISC_USHORT>(svUuid.size());
-                    svUuid.copy(out->uuid.str, out->uuid.length);
-                }
-                else if (keyFieldInfo.isInt()) {
-                    out->idNull = false;
-                    out->id = std::stoll(keyValue);
-                }
-                else {
-                    std::string sMessage = "FTS index does not know the key type.";
-                    throwException(status, sMessage.c_str());
-                }
-            }
-            catch (const std::invalid_argument& e) {
-                throwException(status, e.what());
-            }
+/***
+PROCEDURE FTS$WARMUP_ALL
+RETURNS (
+    FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8,
+    FTS$STEP VARCHAR(10) CHARACTER SET UTF8,
+    FTS$QUERY VARCHAR(8191) CHARACTER SET UTF8,
+    FTS$ELAPSED_MS DOUBLE PRECISION
+)
+EXTERNAL NAME 'luceneudr!ftsWarmupAll'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(ftsWarmupAll)
+    FB_UDR_MESSAGE(OutMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(40, CS_UTF8), step)
+        (FB_INTL_VARCHAR(32765, CS_UTF8), query)
+        (FB_DOUBLE, elapsedMs)
+    );
 
-            out->scoreNull = false;
-            out->score = scoreDoc->score;
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+        , analyzerRepository(std::make_unique<AnalyzerRepository>(context->getMaster()))
+        , relationHelper(std::make_unique<RelationHelper>(context->getMaster()))
+    {
+    }
 
-            if (explainFlag) {
-                auto explanation = searcher->explain(query, scoreDoc->doc);
-                const std::string explanationStr = StringUtils::toUTF8(explanation->toString());
-                out->explanationNull = false;
-                writeStringToBlob(status, att, tra, &out->explanation, explanationStr);
-            }
-            else {
-                out->explanationNull = true;
-            }
+    FTSIndexRepositoryPtr indexRepository;
+    std::unique_ptr<AnalyzerRepository> analyzerRepository;
+    RelationHelperPtr relationHelper;
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        const auto ftsDirectoryPath = getFtsDirectory(status, context);
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        unsigned int sqlDialect = getSqlDialect(status, att);
+
+        const auto indexes = procedure->indexRepository->allIndexes(status, att, tra, sqlDialect, true);
 
-            ++it;
+        try {
+            for (const auto& ftsIndex : indexes) {
+                // inactive and not yet built indexes are not searched
+                const auto indexDirectoryPath = ftsDirectoryPath / ftsIndex.indexName;
+                if (!ftsIndex.isActive() || !fs::is_directory(indexDirectoryPath)) {
+                    continue;
+                }
+                warmupIndex(status, att, tra, sqlDialect, context->getDatabaseName(),
+                    *procedure->indexRepository, *procedure->analyzerRepository, *procedure->relationHelper,
+                    ftsIndex, indexDirectoryPath, steps);
+            }
         }
         catch (const LuceneException& e) {
             const std::string error_message = StringUtils::toUTF8(e.getError());
             throwException(status, error_message.c_str());
         }
+        it = steps.cbegin();
+    }
+
+    std::vector<WarmupStep> steps;
+    std::vector<WarmupStep>::const_iterator it;
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        if (it == steps.cend()) {
+            return false;
+        }
+        out->indexNameNull = false;
+        out->indexName.length = static_cast<ISC_USHORT>(it->indexName.length());
+        it->indexName.copy(out->indexName.str, out->indexName.length);
+
+        writeWarmupStep(out, *it);
+        ++it;
         return true;
     }
 FB_UDR_END_PROCEDURE
@@ -406,11 +1792,16 @@ FB_UDR_END_PROCEDURE
 
 
 /***
-PROCEDURE FTS$UPDATE_INDEXES 
+PROCEDURE FTS$UPDATE_INDEXES (
+    FTS$NEAR_REAL_TIME BOOLEAN DEFAULT FALSE
+)
 EXTERNAL NAME 'luceneudr!updateFtsIndexes'
 ENGINE UDR;
 ***/
 FB_UDR_BEGIN_PROCEDURE(updateFtsIndexes)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_BOOLEAN, nearRealTime)
+    );
 
     FB_UDR_CONSTRUCTOR
         , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
@@ -437,13 +1828,16 @@ FB_UDR_BEGIN_PROCEDURE(updateFtsIndexes)
 
         const unsigned int sqlDialect = getSqlDialect(status, att);
 
+        // in the near-real-time mode the writers stay open and searchers take their readers from them
+        const bool nearRealTime = !in->nearRealTimeNull && in->nearRealTime;
+
         constexpr const char* SQL_DELETE_FTS_LOG = R"SQL(
 DELETE FROM FTS$LOG
-WHERE FTS$LOG_ID = ?
+WHERE FTS$LOG_ID BETWEEN ? AND ?
 )SQL";
 
         constexpr const char* SQL_SELECT_FTS_LOG = R"SQL(
-SELECT
+SELECT FIRST(?)
     FTS$LOG_ID
   , TRIM(FTS$RELATION_NAME) AS FTS$RELATION_NAME
   , FTS$DB_KEY
@@ -451,10 +1845,15 @@ SELECT
   , FTS$REC_ID
   , FTS$CHANGE_TYPE
 FROM FTS$LOG
+WHERE FTS$LOG_ID > ?
 ORDER BY FTS$LOG_ID
 )SQL";
 
         const auto ftsDirectoryPath = getFtsDirectory(status, context);
+
+        // the runs of a database are serialized, they share the log entries applied by the near-real-time writers
+        auto& logState = FTSWriterCache::instance().logState(ftsDirectoryPath);
+        std::lock_guard<std::mutex> logLock(logState.mutex);
         
         // fill map indexes of relationName
         std::unordered_map<std::string, std::list<FTSPreparedIndex>> indexesByRelation;
@@ -478,7 +1877,8 @@ ORDER BY FTS$LOG_ID
                         sqlDialect,
                         std::move(ftsIndex),
                         ftsDirectoryPath,
-                        true);
+                        true,
+                        nearRealTime);
                     list.push_back(std::move(preparedIndex));
                 } catch (const FbException&) {
                     // if prepared error - set index to rebuild
@@ -515,65 +1915,130 @@ ORDER BY FTS$LOG_ID
                 ));
             }
 
+            LogInput logInput(status, context->getMaster());
             LogOutput logOutput(status, context->getMaster());
 
+            // the whole log is reduced to one change per record before it is applied,
+            // so a record changed many times is read from the table and written to the index once per run;
+            // the log is read in chunks in the order of identifiers
+            std::vector<LogChange> changes;
+            std::unordered_map<std::string, size_t> changeIndexes;
+            // only the entries read are deleted, an entry of a transaction committed after the read
+            // may have an identifier between them
+            FTSLogRanges appliedIds;
+            FTSLogRanges deleteIds;
+            logInput->chunkSizeNull = false;
+            logInput->chunkSize = LOG_CHUNK_SIZE;
+            logInput->lastIdNull = false;
+            logInput->lastId = std::numeric_limits<ISC_INT64>::min();
+            for (;;) {
+                AutoRelease<IResultSet> logRs(procedure->logStmt->openCursor(
+                    status,
+                    tra,
+                    logInput.getMetadata(),
+                    logInput.getData(),
+                    logOutput.getMetadata(),
+                    0
+                ));
+
+                unsigned int logCount = 0;
+                while (logRs->fetchNext(status, logOutput.getData()) == IStatus::RESULT_OK) {
+                    logCount++;
+                    const ISC_INT64 logId = logOutput->id;
+                    logInput->lastId = logId;
 
-            AutoRelease<IResultSet> logRs (procedure->logStmt->openCursor(
-                status,
-                tra,
-                nullptr,
-                nullptr,
-                logOutput.getMetadata(),
-                0
-            ));
+                    // the entries applied by the near-real-time writers stay in the log until the writers are committed
+                    if (nearRealTime && logState.applied.contains(logId)) {
+                        continue;
+                    }
 
+                    std::string relationName(logOutput->relationName.str, logOutput->relationName.length);
+                    const char changeType = logOutput->changeType.length > 0 ? logOutput->changeType.str[0] : 'U';
 
-            while (logRs->fetchNext(status, logOutput.getData()) == IStatus::RESULT_OK) {
-                const ISC_INT64 logId = logOutput->id;
-                const std::string relationName(logOutput->relationName.str, logOutput->relationName.length);
-                const std::string_view changeType(logOutput->changeType.str, logOutput->changeType.length);
+                    // the tables without active indexes do not need the log,
+                    // an inactive index is rebuilt when it is activated
+                    const auto iRelation = indexesByRelation.find(relationName);
+                    if (iRelation == indexesByRelation.end()) {
+                        deleteIds.add(logId);
+                        continue;
+                    }
+                    // the entry is in the last commit of all indexes of the table,
+                    // the process terminated before it was deleted
+                    if (isCommitted(iRelation->second, logId)) {
+                        deleteIds.add(logId);
+                        continue;
+                    }
+                    appliedIds.add(logId);
+
+                    LogChange change{
+                        std::move(relationName),
+                        static_cast<bool>(logOutput->dbKeyNull),
+                        std::string(logOutput->dbKey.str, logOutput->dbKeyNull ? 0 : logOutput->dbKey.length),
+                        static_cast<bool>(logOutput->uuidNull),
+                        std::string(logOutput->uuid.str, logOutput->uuidNull ? 0 : logOutput->uuid.length),
+                        static_cast<bool>(logOutput->recIdNull),
+                        logOutput->recIdNull ? 0 : logOutput->recId,
+                        changeType,
+                        changeType
+                    };
+                    auto&& [it, inserted] = changeIndexes.try_emplace(makeLogChangeKey(change), changes.size());
+                    if (inserted) {
+                        changes.push_back(std::move(change));
+                    }
+                    else {
+                        changes[it->second].lastType = changeType;
+                    }
+                }
+                logRs->close(status);
+                logRs.release();
 
+                if (logCount < LOG_CHUNK_SIZE) {
+                    break;
+                }
+            }
+            changeIndexes.clear();
 
-                const auto itIndexes = indexesByRelation.find(relationName);
-                if (itIndexes == indexesByRelation.end()) {
+            for (const auto& change : changes) {
+                const auto changeType = netChangeType(change);
+                if (changeType.empty()) {
                     continue;
                 }
-                auto& preparedIndexes = itIndexes->second;
+                auto& preparedIndexes = indexesByRelation[change.relationName];
 
                 // for all indexes for relationName
                 for (auto& preparedIndex : preparedIndexes) {
                     switch (preparedIndex.keyType()) {
                     case FTSKeyType::DB_KEY:
-                        if (!logOutput->dbKeyNull) {
+                        if (!change.dbKeyNull) {
                             preparedIndex.updateIndexByDbkey(
                                 status,
                                 att,
                                 tra,
-                                reinterpret_cast<unsigned char*>(logOutput->dbKey.str),
-                                logOutput->dbKey.length,
+                                reinterpret_cast<const unsigned char*>(change.dbKey.data()),
+                                static_cast<ISC_USHORT>(change.dbKey.length()),
                                 changeType
-                            );                                
+                            );
                         }
                         break;
                     case FTSKeyType::UUID:
-                        if (!logOutput->uuidNull) {
+                        if (!change.uuidNull) {
                             preparedIndex.updateIndexByUuui(
                                 status,
                                 att,
                                 tra,
-                                reinterpret_cast<unsigned char*>(logOutput->uuid.str),
-                                logOutput->uuid.length,
+                                reinterpret_cast<const unsigned char*>(change.uuid.data()),
+                                static_cast<ISC_USHORT>(change.uuid.length()),
                                 changeType
-                            );                            
+                            );
                         }
                         break;
                     case FTSKeyType::INT_ID:
-                        if (!logOutput->recIdNull) {
+                        if (!change.recIdNull) {
                             preparedIndex.updateIndexById(
                                 status,
                                 att,
                                 tra,
-                                logOutput->recId,
+                                change.recId,
                                 changeType
                             );
                         }
@@ -582,9 +2047,50 @@ ORDER BY FTS$LOG_ID
                         continue;
                     }
                 }
-                // delete record from FTS log
-                logDelInput->idNull = false;
-                logDelInput->id = logId;
+            }
+
+            for (auto&& [relationName, preparedIndexes] : indexesByRelation) {
+                for (auto& preparedIndex : preparedIndexes) {
+                    // the records of the last incomplete batch of keys are read from the table
+                    preparedIndex.flushUpdates(status, att, tra);
+                    if (nearRealTime) {
+                        preparedIndex.publish(status);
+                    }
+                }
+            }
+
+            // the entries are deleted from the log only after their changes are committed,
+            // the commit records them, so they are skipped if the process terminates before the deletion
+            const auto commitAll = [&](const FTSLogRanges& logIds) {
+                for (auto&& [relationName, preparedIndexes] : indexesByRelation) {
+                    for (auto& preparedIndex : preparedIndexes) {
+                        preparedIndex.commit(status, logIds);
+                    }
+                }
+                deleteIds.add(logIds);
+            };
+            const auto now = std::chrono::steady_clock::now();
+            if (nearRealTime) {
+                logState.applied.add(appliedIds);
+                if (now - logState.lastCommit >= FTSLogState::COMMIT_INTERVAL) {
+                    commitAll(logState.applied);
+                    logState.applied.clear();
+                    logState.lastCommit = now;
+                }
+            }
+            else {
+                commitAll(appliedIds);
+                // the entries applied by the near-real-time writers have been read and applied again
+                logState.applied.clear();
+                logState.lastCommit = now;
+            }
+
+            // delete the entries from FTS log with one statement per range of consecutive identifiers
+            for (const auto& [firstId, lastId] : deleteIds.ranges()) {
+                logDelInput->firstIdNull = false;
+                logDelInput->firstId = firstId;
+                logDelInput->lastIdNull = false;
+                logDelInput->lastId = lastId;
                 procedure->logDeleteStmt->execute(
                     status,
                     tra,
@@ -593,16 +2099,13 @@ ORDER BY FTS$LOG_ID
                     nullptr,
                     nullptr
                 );
-                
             }
-            logRs->close(status);
-            logRs.release();
-            // commit changes for all indexes
-            for (auto&& [relationName, preparedIndexes] : indexesByRelation) {
-                for (auto& preparedIndex : preparedIndexes) {
-                    preparedIndex.optimize(status);
-                    preparedIndex.commit(status);
-                    preparedIndex.close(status);
+
+            if (!nearRealTime) {
+                for (auto&& [relationName, preparedIndexes] : indexesByRelation) {
+                    for (auto& preparedIndex : preparedIndexes) {
+                        preparedIndex.close(status);
+                    }
                 }
             }
         }
@@ -612,9 +2115,19 @@ ORDER BY FTS$LOG_ID
         }
     }
 
-    // Input message for the FTS log record delete statement
+    // number of FTS log records read by one statement
+    static constexpr unsigned int LOG_CHUNK_SIZE = 10000;
+
+    // Input message for the FTS log range delete statement
     FB_MESSAGE(LogDelInput, ThrowStatusWrapper,
-        (FB_BIGINT, id)
+        (FB_BIGINT, firstId)
+        (FB_BIGINT, lastId)
+    );
+
+    // Input message for the FTS log chunk statement
+    FB_MESSAGE(LogInput, ThrowStatusWrapper,
+        (FB_INTEGER, chunkSize)
+        (FB_BIGINT, lastId)
     );
 
     // FTS log output message
@@ -634,6 +2147,15 @@ ORDER BY FTS$LOG_ID
     }
 
 
+    // Returns true if the log entry is contained in the last commit of all the indexes.
+    static bool isCommitted(const std::list<FTSPreparedIndex>& preparedIndexes, ISC_INT64 logId)
+    {
+        return !preparedIndexes.empty() &&
+            std::all_of(preparedIndexes.cbegin(), preparedIndexes.cend(), [logId](const FTSPreparedIndex& preparedIndex) {
+                return preparedIndex.committedLogIds().contains(logId);
+            });
+    }
+
     void setIndexToRebuild(ThrowStatusWrapper* status, IAttachment* att, unsigned int sqlDialect, const std::string& indexName)
     {
         // this is done in an autonomous transaction				
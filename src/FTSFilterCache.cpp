@@ -0,0 +1,122 @@
+/**
+ *  Process-wide cache of search filters.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "FTSFilterCache.h"
+
+#include <iterator>
+
+using namespace Lucene;
+
+namespace
+{
+    // approximate memory of the cache entry and of the document set object of a segment
+    constexpr size_t ENTRY_MEMORY_SIZE = 256;
+    constexpr size_t SEGMENT_MEMORY_SIZE = 128;
+
+    bool sameSnapshot(const std::weak_ptr<LuceneUDR::FTSSearcher>& cached, const LuceneUDR::FTSSearcherPtr& searcher)
+    {
+        // owner comparison does not need the cached snapshot to be alive
+        return !cached.owner_before(searcher) && !searcher.owner_before(cached);
+    }
+
+    // The filter keeps a bit set per segment reader it has been applied to.
+    size_t estimateMemorySize(const std::string& key, const LuceneUDR::FTSSearcherPtr& searcher)
+    {
+        size_t memorySize = ENTRY_MEMORY_SIZE + 2 * key.size();
+        for (const auto& reader : searcher->segmentReaders()) {
+            memorySize += SEGMENT_MEMORY_SIZE + static_cast<size_t>(reader->maxDoc()) / 8;
+        }
+        return memorySize;
+    }
+}
+
+namespace LuceneUDR
+{
+
+    FTSFilterCache& FTSFilterCache::instance()
+    {
+        static FTSFilterCache cache(DEFAULT_MEMORY_LIMIT);
+        return cache;
+    }
+
+    FTSFilterCache::FTSFilterCache(size_t memoryLimit)
+        : m_memoryLimit(memoryLimit)
+    {
+    }
+
+    FilterPtr FTSFilterCache::get(const std::string& key, const FTSSearcherPtr& searcher)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_index.find(key);
+        if (it == m_index.end()) {
+            ++m_misses;
+            return nullptr;
+        }
+        const auto entry = it->second;
+        if (!sameSnapshot(entry->searcher, searcher)) {
+            // the filter is applied to the segments of another snapshot, its document sets grow
+            const size_t memorySize = estimateMemorySize(key, searcher);
+            if (memorySize > m_memoryLimit) {
+                remove(entry);
+                ++m_misses;
+                return nullptr;
+            }
+            m_memorySize = m_memorySize - entry->memorySize + memorySize;
+            entry->memorySize = memorySize;
+            entry->searcher = searcher;
+        }
+        ++m_hits;
+        m_entries.splice(m_entries.begin(), m_entries, entry);
+        shrink();
+        return entry->filter;
+    }
+
+    void FTSFilterCache::put(const std::string& key, const FilterPtr& filter, const FTSSearcherPtr& searcher)
+    {
+        const size_t memorySize = estimateMemorySize(key, searcher);
+        if (memorySize > m_memoryLimit) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_index.find(key) != m_index.end()) {
+            // the filter has been created by a concurrent search, its document sets are kept
+            return;
+        }
+        m_entries.push_front({ key, filter, searcher, memorySize });
+        m_index.emplace(key, m_entries.begin());
+        m_memorySize += memorySize;
+        shrink();
+    }
+
+    FTSCacheStatistics FTSFilterCache::statistics()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return { m_memoryLimit, m_memorySize, m_hits, m_misses };
+    }
+
+    void FTSFilterCache::remove(EntryList::iterator it)
+    {
+        m_memorySize -= it->memorySize;
+        m_index.erase(it->key);
+        m_entries.erase(it);
+    }
+
+    void FTSFilterCache::shrink()
+    {
+        // the most recently used filter is never evicted, it fits into the limit
+        while (m_memorySize > m_memoryLimit && m_entries.size() > 1) {
+            remove(std::prev(m_entries.end()));
+        }
+    }
+
+}
@@ -0,0 +1,99 @@
+#ifndef FTS_FILTER_CACHE_H
+#define FTS_FILTER_CACHE_H
+
+/**
+ *  Process-wide cache of search filters.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "FTSQueryCache.h"
+#include "FTSSearcherCache.h"
+#include "LuceneHeaders.h"
+
+namespace LuceneUDR
+{
+
+    /// <summary>
+    /// LRU cache of search filters shared by all attachments.
+    ///
+    /// The filters cache the document sets of each segment reader they have been applied to.
+    /// Segment readers are kept when the searcher is reopened after a commit,
+    /// so a repeated filter is only evaluated again for the new segments of the index.
+    /// The document sets are dropped together with the segment readers.
+    /// The cache is bounded by the estimated memory of the document sets:
+    /// one bit per document of each segment of the index snapshot.
+    /// </summary>
+    class FTSFilterCache final
+    {
+    public:
+        static constexpr size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+        static FTSFilterCache& instance();
+
+        explicit FTSFilterCache(size_t memoryLimit);
+
+        // non-copyable
+        FTSFilterCache(const FTSFilterCache& rhs) = delete;
+        FTSFilterCache& operator=(const FTSFilterCache& rhs) = delete;
+
+        /// <summary>
+        /// Returns the cached filter.
+        /// </summary>
+        ///
+        /// <param name="key">Key of the filter: index directory and filter terms.</param>
+        /// <param name="searcher">Index snapshot the filter is applied to.</param>
+        ///
+        /// <returns>Filter or nullptr if it is not cached.</returns>
+        Lucene::FilterPtr get(const std::string& key, const FTSSearcherPtr& searcher);
+
+        /// <summary>
+        /// Puts the filter into the cache, the least recently used filters are evicted.
+        /// </summary>
+        ///
+        /// <param name="key">Key of the filter: index directory and filter terms.</param>
+        /// <param name="filter">Caching filter.</param>
+        /// <param name="searcher">Index snapshot the filter is applied to.</param>
+        void put(const std::string& key, const Lucene::FilterPtr& filter, const FTSSearcherPtr& searcher);
+
+        FTSCacheStatistics statistics();
+
+    private:
+        struct Entry
+        {
+            std::string key;
+            Lucene::FilterPtr filter;
+            std::weak_ptr<FTSSearcher> searcher;
+            size_t memorySize;
+        };
+        using EntryList = std::list<Entry>;
+
+        void remove(EntryList::iterator it);
+        void shrink();
+
+        std::mutex m_mutex;
+        size_t m_memoryLimit;
+        size_t m_memorySize = 0;
+        EntryList m_entries; // most recently used first
+        std::unordered_map<std::string, EntryList::iterator> m_index;
+        uint64_t m_hits = 0;
+        uint64_t m_misses = 0;
+    };
+
+}
+
+#endif // FTS_FILTER_CACHE_H
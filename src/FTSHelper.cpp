@@ -16,14 +16,93 @@
 #include "Analyzers.h"
 #include "FBUtils.h"
 #include "FTSUtils.h"
+#include "FieldCache.h"
+#include "LogByteSizeMergePolicy.h"
+#include "MMapDirectory.h"
+#include "NumericUtils.h"
 
-
+namespace
+{
+    // commit user data key that holds the key encoding of the index
+    const wchar_t* const KEY_ENCODING_USER_DATA = L"FTS$KEY_ENCODING";
+    // commit user data key that holds the ranges of FTS$LOG identifiers applied by the commit
+    const wchar_t* const LOG_IDS_USER_DATA = L"FTS$LOG_ID";
+    // more ranges are not recorded, the entries are then applied again after a restart
+    constexpr size_t MAX_COMMITTED_LOG_RANGES = 1000;
+    // prefix of the fields that hold the sort values, it can not clash with the names of the table fields
+    const wchar_t* const SORT_FIELD_PREFIX = L"FTS$SORT$";
+}
 
 namespace LuceneUDR
 {
     using namespace Firebird;
     using namespace Lucene;
 
+    FTSMetadata::FTSKeyEncoding getKeyEncoding(const MapStringString& commitUserData)
+    {
+        if (!commitUserData || !commitUserData.contains(KEY_ENCODING_USER_DATA)) {
+            return FTSMetadata::FTSKeyEncoding::TEXT;
+        }
+        const std::string sKeyEncoding = StringUtils::toUTF8(commitUserData.get(KEY_ENCODING_USER_DATA));
+        return FTSMetadata::FTSKeyEncodingFromString(sKeyEncoding);
+    }
+
+    MapStringString makeCommitUserData(FTSMetadata::FTSKeyEncoding keyEncoding, const FTSLogRanges& logIds)
+    {
+        auto commitUserData = MapStringString::newInstance();
+        commitUserData.put(KEY_ENCODING_USER_DATA, StringUtils::toUnicode(FTSMetadata::FTSKeyEncodingToString(keyEncoding)));
+        if (!logIds.empty() && logIds.ranges().size() <= MAX_COMMITTED_LOG_RANGES) {
+            commitUserData.put(LOG_IDS_USER_DATA, StringUtils::toUnicode(logIds.toString()));
+        }
+        return commitUserData;
+    }
+
+    FTSLogRanges getCommittedLogIds(const MapStringString& commitUserData)
+    {
+        if (!commitUserData || !commitUserData.contains(LOG_IDS_USER_DATA)) {
+            return {};
+        }
+        return FTSLogRanges::fromString(StringUtils::toUTF8(commitUserData.get(LOG_IDS_USER_DATA)));
+    }
+
+    String binaryKeyToTerm(const unsigned char* data, size_t length, FTSMetadata::FTSKeyEncoding keyEncoding)
+    {
+        if (keyEncoding == FTSMetadata::FTSKeyEncoding::TEXT) {
+            return StringUtils::toUnicode(binary_to_hex(data, length));
+        }
+        // one character per byte, no formatting is required
+        return String(data, data + length);
+    }
+
+    std::vector<unsigned char> keyTermToBinary(const String& term, FTSMetadata::FTSKeyEncoding keyEncoding)
+    {
+        if (keyEncoding == FTSMetadata::FTSKeyEncoding::TEXT) {
+            return hex_to_binary(StringUtils::toUTF8(term));
+        }
+        std::vector<unsigned char> value;
+        value.reserve(term.length());
+        for (const auto ch : term) {
+            value.push_back(static_cast<unsigned char>(ch));
+        }
+        return value;
+    }
+
+    String intKeyToTerm(ISC_INT64 id, FTSMetadata::FTSKeyEncoding keyEncoding)
+    {
+        if (keyEncoding == FTSMetadata::FTSKeyEncoding::TEXT) {
+            return StringUtils::toUnicode(std::to_string(id));
+        }
+        return NumericUtils::longToPrefixCoded(id);
+    }
+
+    ISC_INT64 keyTermToInt(const String& term, FTSMetadata::FTSKeyEncoding keyEncoding)
+    {
+        if (keyEncoding == FTSMetadata::FTSKeyEncoding::TEXT) {
+            return std::stoll(StringUtils::toUTF8(term));
+        }
+        return NumericUtils::prefixCodedToLong(term);
+    }
+
     FTSPreparedIndex prepareFtsIndex(
         Firebird::ThrowStatusWrapper* status,
         Firebird::IMaster* master,
@@ -32,9 +111,10 @@ namespace LuceneUDR
         unsigned int sqlDialect,
         FTSMetadata::FTSIndex&& ftsIndex,
         const std::filesystem::path& ftsDirectoryPath,
-        bool whereKey)
+        bool whereKey,
+        bool nearRealTime)
     {
-        return FTSPreparedIndex(status, master, att, tra, sqlDialect, std::move(ftsIndex), ftsDirectoryPath, whereKey);
+        return FTSPreparedIndex(status, master, att, tra, sqlDialect, std::move(ftsIndex), ftsDirectoryPath, whereKey, nearRealTime);
     }
 
     FTSPreparedIndex::FTSPreparedIndex(
@@ -45,7 +125,8 @@ namespace LuceneUDR
         unsigned int sqlDialect,
         FTSMetadata::FTSIndex&& ftsIndex,
         const std::filesystem::path& ftsDirectoryPath,
-        bool whereKey
+        bool whereKey,
+        bool nearRealTime
     )
         : m_master(master)
         , m_ftsIndex(std::move(ftsIndex))
@@ -56,7 +137,12 @@ namespace LuceneUDR
         , m_inMetaExtractRecord{ nullptr }
         , m_outMetaExtractRecord{ nullptr }
         , m_outputBuffer()
+        , m_inputBuffer()
+        , m_keyOffsets()
+        , m_keyNullOffsets()
+        , m_pendingUpdates()
         , m_indexWriter()
+        , m_nrtWriter()
         , m_unicodeKeyFieldName()
     {
         // check segments exists
@@ -81,7 +167,8 @@ namespace LuceneUDR
             }
         }
 
-        std::string sql = m_ftsIndex.buildSqlSelectFieldValues(status, sqlDialect, whereKey);
+        // the changed records are read by batches of keys
+        std::string sql = m_ftsIndex.buildSqlSelectFieldValues(status, sqlDialect, whereKey, KEY_BATCH_SIZE);
 
         m_stmtExtractRecord.reset(att->prepare(
             status,
@@ -103,7 +190,7 @@ namespace LuceneUDR
         // parameters description
         const auto paramCount = m_inMetaExtractRecord->getCount(status);
         if (whereKey) {
-            if (paramCount != 1) {
+            if (paramCount != KEY_BATCH_SIZE) {
                 auto iscStatus = IscRandomStatus::createFmtStatus(
                     R"(Invalid FTS index "%s". Updates are only supported for single-key indexes.)",
                     m_ftsIndex.indexName.c_str()
@@ -138,6 +225,29 @@ namespace LuceneUDR
                     m_ftsIndex.indexName.c_str());
                 throw FbException(status, iscStatus);
             }
+
+            // the keys are passed as BIGINT or as binary strings of the key length, as they are stored in the log
+            AutoRelease<IMetadataBuilder> builder(m_inMetaExtractRecord->getBuilder(status));
+            for (unsigned i = 0; i < paramCount; i++) {
+                if (m_ftsIndex.keyFieldType == FTSMetadata::FTSKeyType::INT_ID) {
+                    builder->setType(status, i, SQL_INT64);
+                    builder->setLength(status, i, sizeof(ISC_INT64));
+                    builder->setScale(status, i, 0);
+                }
+                else {
+                    builder->setType(status, i, SQL_VARYING);
+                    builder->setLength(status, i, keyParam.length);
+                    builder->setCharSet(status, i, CS_BINARY);
+                }
+            }
+            m_inMetaExtractRecord.reset(builder->getMetadata(status));
+            m_inputBuffer = std::vector<unsigned char>(m_inMetaExtractRecord->getMessageLength(status));
+            m_keyOffsets.reserve(paramCount);
+            m_keyNullOffsets.reserve(paramCount);
+            for (unsigned i = 0; i < paramCount; i++) {
+                m_keyOffsets.push_back(m_inMetaExtractRecord->getOffset(status, i));
+                m_keyNullOffsets.push_back(m_inMetaExtractRecord->getNullOffset(status, i));
+            }
         }
 
         // field description
@@ -166,7 +276,19 @@ namespace LuceneUDR
             field.ftsBoostNull = segment.isBoostNull();
             if (field.ftsKey) {
                 m_unicodeKeyFieldName = field.ftsFieldName;
+                m_keyFieldIndex = static_cast<size_t>(&field - m_fields.data());
+            }
+        }
+
+        // sortable fields get a second, not analyzed field with the sort values
+        FTSMetadata::RelationHelper relationHelper(master);
+        for (size_t i = 0; i < m_fields.size(); i++) {
+            const auto& segment = *m_ftsIndex.findSegment(m_fields[i].fieldName);
+            if (!segment.isSortable() || segment.isKey()) {
+                continue;
             }
+            const auto fieldInfo = relationHelper.getField(status, att, tra, sqlDialect, m_ftsIndex.relationName, segment.fieldName());
+            m_sortableFields.push_back({ i, getSortFieldName(segment.fieldName()), getSortType(fieldInfo) });
         }
 
         // Check if the index directory exists, and if it doesn't exist, create it.
@@ -178,14 +300,39 @@ namespace LuceneUDR
             throw FbException(status, iscStatus);
         }
 
+        // the index in the near-real-time mode already has an open writer, which holds the write lock
+        m_nrtWriter = FTSWriterCache::instance().find(m_indexDirectoryPath);
+        if (m_nrtWriter) {
+            m_indexWriter = m_nrtWriter->writer();
+            m_keyEncoding = m_nrtWriter->keyEncoding();
+            return;
+        }
+
         FTSMetadata::AnalyzerRepository analyzerRepository(master);
-        auto wIndexDirectoryPath = m_indexDirectoryPath.wstring();
 
         try {
-            auto fsIndexDir = FSDirectory::open(wIndexDirectoryPath);
+            auto fsIndexDir = openIndexDirectory(m_indexDirectoryPath, m_ftsIndex.storage);
             bool created = fsIndexDir->listAll().empty();
             auto analyzer = analyzerRepository.createAnalyzer(status, att, tra, sqlDialect, m_ftsIndex.analyzer);
             m_indexWriter = newLucene<IndexWriter>(fsIndexDir, analyzer, created, IndexWriter::MaxFieldLengthUNLIMITED);
+            // segments of similar size are merged in the background of the updates,
+            // so a small change rewrites only small segments, the full merge is done by FTS$OPTIMIZE_INDEX
+            auto mergePolicy = newLucene<LogByteSizeMergePolicy>(m_indexWriter);
+            mergePolicy->setMergeFactor(m_ftsIndex.mergeFactor);
+            m_indexWriter->setMergePolicy(mergePolicy);
+            // an existing index keeps its key encoding until it is rebuilt
+            if (created) {
+                m_keyEncoding = m_ftsIndex.keyEncoding;
+            }
+            else {
+                const auto commitUserData = IndexReader::getCommitUserData(fsIndexDir);
+                m_keyEncoding = getKeyEncoding(commitUserData);
+                // the log entries of the last commit may still be in FTS$LOG if the process terminated before they were deleted
+                m_committedLogIds = getCommittedLogIds(commitUserData);
+            }
+            if (nearRealTime) {
+                m_nrtWriter = FTSWriterCache::instance().put(m_indexDirectoryPath, m_indexWriter, m_keyEncoding);
+            }
         } catch (const LuceneException& e) {
             const std::string error_message = StringUtils::toUTF8(e.getError());
             auto iscStatus = IscRandomStatus(error_message);
@@ -197,48 +344,145 @@ namespace LuceneUDR
     try
     {
         m_indexWriter->deleteAll();
+        // the index is filled again, so the configured key encoding can be applied
+        m_keyEncoding = m_ftsIndex.keyEncoding;
     } catch (const LuceneException& e) {
         const std::string error_message = StringUtils::toUTF8(e.getError());
         auto iscStatus = IscRandomStatus(error_message);
         throw FbException(status, iscStatus);
     }
 
-    void FTSPreparedIndex::optimize(Firebird::ThrowStatusWrapper* status)
+    void FTSPreparedIndex::rollback(Firebird::ThrowStatusWrapper* status)
     try {
-        m_indexWriter->optimize();
+        m_indexWriter->rollback();
     } catch (const LuceneException& e) {
         const std::string error_message = StringUtils::toUTF8(e.getError());
         auto iscStatus = IscRandomStatus(error_message);
         throw FbException(status, iscStatus);
     }
 
-    void FTSPreparedIndex::rollback(Firebird::ThrowStatusWrapper* status)
+    void FTSPreparedIndex::commit(Firebird::ThrowStatusWrapper* status, const FTSLogRanges& logIds)
     try {
-        m_indexWriter->rollback();
+        if (m_nrtWriter) {
+            m_nrtWriter->commit(logIds);
+        }
+        else {
+            m_indexWriter->commit(makeCommitUserData(m_keyEncoding, logIds));
+        }
     } catch (const LuceneException& e) {
         const std::string error_message = StringUtils::toUTF8(e.getError());
         auto iscStatus = IscRandomStatus(error_message);
         throw FbException(status, iscStatus);
     }
 
-    void FTSPreparedIndex::commit(Firebird::ThrowStatusWrapper* status)
+    void FTSPreparedIndex::close(Firebird::ThrowStatusWrapper* status)
     try {
-        m_indexWriter->commit();
+        if (m_nrtWriter) {
+            // the index leaves the near-real-time mode, searchers return to the committed snapshots
+            FTSWriterCache::instance().remove(m_indexDirectoryPath);
+            m_nrtWriter.reset();
+        }
+        m_indexWriter->close();
     } catch (const LuceneException& e) {
         const std::string error_message = StringUtils::toUTF8(e.getError());
         auto iscStatus = IscRandomStatus(error_message);
         throw FbException(status, iscStatus);
     }
 
-    void FTSPreparedIndex::close(Firebird::ThrowStatusWrapper* status)
+    void FTSPreparedIndex::publish(Firebird::ThrowStatusWrapper* status)
     try {
-        m_indexWriter->close();
+        if (m_nrtWriter && m_changed) {
+            m_nrtWriter->publish();
+            m_changed = false;
+        }
     } catch (const LuceneException& e) {
         const std::string error_message = StringUtils::toUTF8(e.getError());
         auto iscStatus = IscRandomStatus(error_message);
         throw FbException(status, iscStatus);
     }
 
+    FTSMetadata::FTSSortType getSortType(const FTSMetadata::RelationFieldInfo& fieldInfo)
+    {
+        switch (fieldInfo.fieldType) {
+        case 7:  // SMALLINT
+        case 8:  // INTEGER
+        case 16: // BIGINT
+            // NUMERIC and DECIMAL are stored as scaled integers
+            return fieldInfo.fieldScale == 0 ? FTSMetadata::FTSSortType::LONG : FTSMetadata::FTSSortType::DOUBLE;
+        case 10: // FLOAT
+        case 11: // D_FLOAT
+        case 24: // DECFLOAT(16)
+        case 25: // DECFLOAT(34)
+        case 26: // INT128
+        case 27: // DOUBLE PRECISION
+            return FTSMetadata::FTSSortType::DOUBLE;
+        default:
+            // strings, booleans, and dates and times in ISO format
+            return FTSMetadata::FTSSortType::STRING;
+        }
+    }
+
+    String getSortFieldName(const std::string& fieldName)
+    {
+        return SORT_FIELD_PREFIX + StringUtils::toUnicode(fieldName);
+    }
+
+    String makeSortTerm(const std::string& value, FTSMetadata::FTSSortType sortType)
+    {
+        switch (sortType) {
+        case FTSMetadata::FTSSortType::LONG:
+            return NumericUtils::longToPrefixCoded(std::stoll(value));
+        case FTSMetadata::FTSSortType::DOUBLE:
+            return NumericUtils::doubleToPrefixCoded(std::stod(value));
+        default:
+            return StringUtils::toUnicode(value);
+        }
+    }
+
+    SortPtr makeSort(const std::string& fieldName, FTSMetadata::FTSSortType sortType, bool reverse)
+    {
+        const String sortFieldName = getSortFieldName(fieldName);
+        SortFieldPtr sortField;
+        switch (sortType) {
+        case FTSMetadata::FTSSortType::LONG:
+            sortField = newLucene<SortField>(sortFieldName, FieldCache::NUMERIC_UTILS_LONG_PARSER(), reverse);
+            break;
+        case FTSMetadata::FTSSortType::DOUBLE:
+            sortField = newLucene<SortField>(sortFieldName, FieldCache::NUMERIC_UTILS_DOUBLE_PARSER(), reverse);
+            break;
+        default:
+            sortField = newLucene<SortField>(sortFieldName, SortField::STRING, reverse);
+            break;
+        }
+        return newLucene<Sort>(sortField);
+    }
+
+    DirectoryPtr openIndexDirectory(const std::filesystem::path& indexDirectoryPath, FTSMetadata::FTSStorage storage)
+    {
+        if (storage == FTSMetadata::FTSStorage::MMAP) {
+            return newLucene<MMapDirectory>(indexDirectoryPath.wstring());
+        }
+        return FSDirectory::open(indexDirectoryPath.wstring());
+    }
+
+    Lucene::String FTSPreparedIndex::makeKeyTerm(
+        Firebird::ThrowStatusWrapper* status,
+        Firebird::IAttachment* att,
+        Firebird::ITransaction* tra,
+        const FTSMetadata::FbFieldInfo& field)
+    {
+        unsigned char* buffer = m_outputBuffer.data();
+        if (m_keyEncoding == FTSMetadata::FTSKeyEncoding::TEXT || field.isNull(buffer)) {
+            return StringUtils::toUnicode(field.getStringValue(status, att, tra, buffer));
+        }
+        if (field.isBinary()) {
+            return binaryKeyToTerm(field.getBinaryValue(buffer), field.getOctetsLength(buffer), m_keyEncoding);
+        }
+        // integer keys are fetched as text
+        const std::string value = field.getStringValue(status, att, tra, buffer);
+        return intKeyToTerm(std::stoll(value), m_keyEncoding);
+    }
+
     Lucene::DocumentPtr FTSPreparedIndex::makeDocument(
         Firebird::ThrowStatusWrapper* status,
         Firebird::IAttachment* att,
@@ -248,13 +492,13 @@ namespace LuceneUDR
         auto doc = newLucene<Document>();
 
         for (const auto& field : m_fields) {
-            const std::string value = field.getStringValue(status, att, tra, m_outputBuffer.data());
-            Lucene::String unicodeValue = StringUtils::toUnicode(value);
             // add field to document
             if (field.ftsKey) {
-                auto luceneField = newLucene<Field>(field.ftsFieldName, unicodeValue, Field::STORE_YES, Field::INDEX_NOT_ANALYZED);
+                auto luceneField = newLucene<Field>(field.ftsFieldName, makeKeyTerm(status, att, tra, field), Field::STORE_YES, Field::INDEX_NOT_ANALYZED);
                 doc->add(luceneField);
             } else {
+                const std::string value = field.getStringValue(status, att, tra, m_outputBuffer.data());
+                Lucene::String unicodeValue = StringUtils::toUnicode(value);
                 auto luceneField = newLucene<Field>(field.ftsFieldName, unicodeValue, Field::STORE_NO, Field::INDEX_ANALYZED);
                 if (!field.ftsBoostNull) {
                     luceneField->setBoost(field.ftsBoost);
@@ -263,6 +507,27 @@ namespace LuceneUDR
                 emptyFlag = emptyFlag && unicodeValue.empty();
             }
         }
+        for (const auto& sortableField : m_sortableFields) {
+            // NULL values have no sort term
+            const auto& field = m_fields[sortableField.fieldIndex];
+            if (field.isNull(m_outputBuffer.data())) {
+                continue;
+            }
+            const std::string value = field.getStringValue(status, att, tra, m_outputBuffer.data());
+            try {
+                auto luceneField = newLucene<Field>(sortableField.sortFieldName, makeSortTerm(value, sortableField.sortType),
+                    Field::STORE_NO, Field::INDEX_NOT_ANALYZED_NO_NORMS);
+                doc->add(luceneField);
+            }
+            catch (const std::logic_error&) {
+                auto iscStatus = IscRandomStatus::createFmtStatus(
+                    R"(Invalid value "%s" of sortable field "%s".)",
+                    value.c_str(),
+                    field.fieldName.c_str()
+                );
+                throw FbException(status, iscStatus);
+            }
+        }
         if (emptyFlag) { 
             doc.reset();
         }
@@ -302,8 +567,8 @@ namespace LuceneUDR
         std::string_view changeType
     )
     {
-        std::string sId = std::to_string(id);
-        Lucene::String unicodeKeyValue = StringUtils::toUnicode(sId);
+        m_changed = true;
+        const Lucene::String unicodeKeyValue = intKeyToTerm(id, m_keyEncoding);
 
         if (changeType == "D") {
             TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, unicodeKeyValue);
@@ -311,41 +576,10 @@ namespace LuceneUDR
             return;
         }
 
-        FB_MESSAGE(IDInput, Firebird::ThrowStatusWrapper,
-            (FB_BIGINT, id)
-        ) input(status, m_master);
-
-        input->idNull = FB_FALSE;
-        input->id = id;
-
-        AutoRelease<IResultSet> rs(
-            m_stmtExtractRecord->openCursor(
-                status,
-                tra,
-                input.getMetadata(),
-                input.getData(),
-                m_outMetaExtractRecord,
-                0
-            )        
-        );
-
-        while (rs->fetchNext(status, m_outputBuffer.data()) == IStatus::RESULT_OK) {
-            auto doc = makeDocument(status, att, tra);
-
-            if ((changeType == "I") && doc) {
-                m_indexWriter->addDocument(doc);
-            }
-            if (changeType == "U") {
-                TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, unicodeKeyValue);
-                if (doc) {
-                    m_indexWriter->updateDocument(term, doc);
-                } else {
-                    m_indexWriter->deleteDocuments(term);
-                }
-            }
-        }
-        rs->close(status);
-        rs.release();
+        unsigned char* buffer = m_inputBuffer.data();
+        *reinterpret_cast<ISC_SHORT*>(buffer + m_keyNullOffsets[m_pendingCount]) = FB_FALSE;
+        *reinterpret_cast<ISC_INT64*>(buffer + m_keyOffsets[m_pendingCount]) = id;
+        queueUpdate(status, att, tra, unicodeKeyValue, changeType);
     } // void FTSPreparedIndex::updateIndexById()
 
     void FTSPreparedIndex::updateIndexByUuui(
@@ -356,8 +590,8 @@ namespace LuceneUDR
         ISC_USHORT uuidLength,
         std::string_view changeType)
     {
-        std::string sUuid = binary_to_hex(uuid, uuidLength);
-        Lucene::String unicodeKeyValue = StringUtils::toUnicode(sUuid);
+        m_changed = true;
+        const Lucene::String unicodeKeyValue = binaryKeyToTerm(uuid, uuidLength, m_keyEncoding);
 
         if (changeType == "D") {
             TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, unicodeKeyValue);
@@ -365,40 +599,8 @@ namespace LuceneUDR
             return;
         }
 
-        FB_MESSAGE(UUIDInput, ThrowStatusWrapper,
-            (FB_INTL_VARCHAR(16, CS_BINARY), uuid))
-        input(status, m_master);
-
-        input->uuidNull = FB_FALSE;
-        input->uuid.length = uuidLength;
-        memcpy(input->uuid.str, uuid, uuidLength);
-
-        AutoRelease<IResultSet> rs(
-            m_stmtExtractRecord->openCursor(
-                status,
-                tra,
-                input.getMetadata(),
-                input.getData(),
-                m_outMetaExtractRecord,
-                0));
-
-        while (rs->fetchNext(status, m_outputBuffer.data()) == IStatus::RESULT_OK) {
-            auto doc = makeDocument(status, att, tra);
-
-            if ((changeType == "I") && doc) {
-                m_indexWriter->addDocument(doc);
-            }
-            if (changeType == "U") {
-                TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, unicodeKeyValue);
-                if (doc) {
-                    m_indexWriter->updateDocument(term, doc);
-                } else {
-                    m_indexWriter->deleteDocuments(term);
-                }
-            }
-        }
-        rs->close(status);
-        rs.release();
+        putBinaryKey(uuid, uuidLength);
+        queueUpdate(status, att, tra, unicodeKeyValue, changeType);
     }
 
     void FTSPreparedIndex::updateIndexByDbkey(
@@ -409,8 +611,8 @@ namespace LuceneUDR
         ISC_USHORT dbkeyLength,
         std::string_view changeType)
     {
-        std::string sDbkey = binary_to_hex(dbkey, dbkeyLength);
-        Lucene::String unicodeKeyValue = StringUtils::toUnicode(sDbkey);
+        m_changed = true;
+        const Lucene::String unicodeKeyValue = binaryKeyToTerm(dbkey, dbkeyLength, m_keyEncoding);
 
         if (changeType == "D") {
             TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, unicodeKeyValue);
@@ -418,30 +620,68 @@ namespace LuceneUDR
             return;
         }
 
-        FB_MESSAGE(UUIDInput, ThrowStatusWrapper,
-            (FB_INTL_VARCHAR(8, CS_BINARY), dbkey))
-        input(status, m_master);
+        putBinaryKey(dbkey, dbkeyLength);
+        queueUpdate(status, att, tra, unicodeKeyValue, changeType);
+    }
 
-        input->dbkeyNull = FB_FALSE;
-        input->dbkey.length = dbkeyLength;
-        memcpy(input->dbkey.str, dbkey, dbkeyLength);
+    void FTSPreparedIndex::putBinaryKey(const unsigned char* key, ISC_USHORT keyLength)
+    {
+        unsigned char* buffer = m_inputBuffer.data();
+        *reinterpret_cast<ISC_SHORT*>(buffer + m_keyNullOffsets[m_pendingCount]) = FB_FALSE;
+        unsigned char* varying = buffer + m_keyOffsets[m_pendingCount];
+        *reinterpret_cast<ISC_USHORT*>(varying) = keyLength;
+        memcpy(varying + sizeof(ISC_USHORT), key, keyLength);
+    }
+
+    void FTSPreparedIndex::queueUpdate(
+        Firebird::ThrowStatusWrapper* status,
+        Firebird::IAttachment* att,
+        Firebird::ITransaction* tra,
+        const Lucene::String& keyTerm,
+        std::string_view changeType)
+    {
+        m_pendingUpdates[keyTerm] = changeType == "I" ? 'I' : 'U';
+        if (++m_pendingCount == KEY_BATCH_SIZE) {
+            flushUpdates(status, att, tra);
+        }
+    }
+
+    void FTSPreparedIndex::flushUpdates(
+        Firebird::ThrowStatusWrapper* status,
+        Firebird::IAttachment* att,
+        Firebird::ITransaction* tra)
+    {
+        if (m_pendingCount == 0) {
+            return;
+        }
+
+        // the unused keys are NULL, they do not match any record
+        unsigned char* buffer = m_inputBuffer.data();
+        for (unsigned i = m_pendingCount; i < KEY_BATCH_SIZE; i++) {
+            *reinterpret_cast<ISC_SHORT*>(buffer + m_keyNullOffsets[i]) = FB_TRUE;
+        }
 
         AutoRelease<IResultSet> rs(
             m_stmtExtractRecord->openCursor(
                 status,
                 tra,
-                input.getMetadata(),
-                input.getData(),
+                m_inMetaExtractRecord,
+                buffer,
                 m_outMetaExtractRecord,
                 0));
 
         while (rs->fetchNext(status, m_outputBuffer.data()) == IStatus::RESULT_OK) {
+            const Lucene::String unicodeKeyValue = makeKeyTerm(status, att, tra, m_fields[m_keyFieldIndex]);
+            const auto it = m_pendingUpdates.find(unicodeKeyValue);
+            if (it == m_pendingUpdates.end()) {
+                continue;
+            }
             auto doc = makeDocument(status, att, tra);
 
-            if ((changeType == "I") && doc) {
+            if ((it->second == 'I') && doc) {
                 m_indexWriter->addDocument(doc);
             }
-            if (changeType == "U") {
+            if (it->second == 'U') {
                 TermPtr term = newLucene<Term>(m_unicodeKeyFieldName, unicodeKeyValue);
                 if (doc) {
                     m_indexWriter->updateDocument(term, doc);
@@ -452,6 +692,9 @@ namespace LuceneUDR
         }
         rs->close(status);
         rs.release();
+
+        m_pendingUpdates.clear();
+        m_pendingCount = 0;
     }
 
 }
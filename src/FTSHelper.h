@@ -15,17 +15,93 @@
 **/
 
 #include <filesystem>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "FBFieldInfo.h"
 #include "FTSIndex.h"
+#include "FTSWriterCache.h"
 #include "LuceneHeaders.h"
 #include "LuceneUdr.h"
+#include "Relations.h"
 
 namespace LuceneUDR
 {
+    /// <summary>
+    /// Returns the key encoding recorded in the commit user data of the index.
+    ///
+    /// Indexes created before the encoding was recorded use the text encoding.
+    /// </summary>
+    FTSMetadata::FTSKeyEncoding getKeyEncoding(const Lucene::MapStringString& commitUserData);
+
+    /// <summary>
+    /// Returns the commit user data that records the key encoding of the index
+    /// and the FTS$LOG entries whose changes are contained in the commit.
+    /// </summary>
+    Lucene::MapStringString makeCommitUserData(FTSMetadata::FTSKeyEncoding keyEncoding, const FTSLogRanges& logIds = FTSLogRanges());
+
+    /// <summary>
+    /// Returns the FTS$LOG entries recorded in the commit user data of the index.
+    /// </summary>
+    FTSLogRanges getCommittedLogIds(const Lucene::MapStringString& commitUserData);
+
+    /// <summary>
+    /// Converts the binary key value (DB_KEY or UUID) to the key term.
+    /// </summary>
+    Lucene::String binaryKeyToTerm(const unsigned char* data, size_t length, FTSMetadata::FTSKeyEncoding keyEncoding);
+
+    /// <summary>
+    /// Converts the key term back to the binary key value (DB_KEY or UUID).
+    /// </summary>
+    std::vector<unsigned char> keyTermToBinary(const Lucene::String& term, FTSMetadata::FTSKeyEncoding keyEncoding);
+
+    /// <summary>
+    /// Converts the integer key value to the key term.
+    /// </summary>
+    Lucene::String intKeyToTerm(ISC_INT64 id, FTSMetadata::FTSKeyEncoding keyEncoding);
+
+    /// <summary>
+    /// Converts the key term back to the integer key value.
+    /// </summary>
+    ISC_INT64 keyTermToInt(const Lucene::String& term, FTSMetadata::FTSKeyEncoding keyEncoding);
+
+    /// <summary>
+    /// Returns the order of the values of the sortable field by its data type.
+    /// </summary>
+    FTSMetadata::FTSSortType getSortType(const FTSMetadata::RelationFieldInfo& fieldInfo);
+
+    /// <summary>
+    /// Returns the name of the not analyzed field that holds the sort values of the index field.
+    /// </summary>
+    Lucene::String getSortFieldName(const std::string& fieldName);
+
+    /// <summary>
+    /// Converts the text value of the sortable field to its sort term.
+    ///
+    /// Numbers are trie-encoded, so the terms are ordered as the numbers.
+    /// </summary>
+    Lucene::String makeSortTerm(const std::string& value, FTSMetadata::FTSSortType sortType);
+
+    /// <summary>
+    /// Returns the sort of the search results by the sortable index field.
+    /// </summary>
+    Lucene::SortPtr makeSort(const std::string& fieldName, FTSMetadata::FTSSortType sortType, bool reverse);
+
+    /// <summary>
+    /// Opens the index directory on the disk with the I/O strategy of the index storage.
+    ///
+    /// The RAM storage keeps the index on the disk as well, so its files are opened with buffered reads,
+    /// the copy in memory is made by the searcher cache.
+    /// </summary>
+    Lucene::DirectoryPtr openIndexDirectory(const std::filesystem::path& indexDirectoryPath, FTSMetadata::FTSStorage storage);
+
     class FTSPreparedIndex final
     {
     public:
+        // number of records read from the table by one statement when the index is updated
+        static constexpr unsigned int KEY_BATCH_SIZE = 64;
+
         FTSPreparedIndex() = default;
 
         FTSPreparedIndex(
@@ -36,7 +112,8 @@ namespace LuceneUDR
             unsigned int sqlDialect,
             FTSMetadata::FTSIndex&& ftsIndex,
             const std::filesystem::path& ftsDirectoryPath,
-            bool whereKey);
+            bool whereKey,
+            bool nearRealTime = false);
 
         // non-copyable
         FTSPreparedIndex(const FTSPreparedIndex& rhs) = delete;
@@ -77,12 +154,44 @@ namespace LuceneUDR
             std::string_view changeType
         );
 
+        /// <summary>
+        /// Reads the records of the queued insertions and updates from the table and writes them to the index.
+        ///
+        /// The updateIndexBy* methods collect the keys of the changed records
+        /// and read them with one statement per KEY_BATCH_SIZE keys,
+        /// so the pending changes must be flushed before the index is committed.
+        /// </summary>
+        void flushUpdates(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra
+        );
+
         void deleteAll(Firebird::ThrowStatusWrapper* status);
-        void optimize(Firebird::ThrowStatusWrapper* status);
-        void commit(Firebird::ThrowStatusWrapper* status);
+
+        /// <summary>
+        /// Commits the changes of the index.
+        /// </summary>
+        ///
+        /// <param name="logIds">FTS$LOG entries whose changes are contained in the commit.</param>
+        void commit(Firebird::ThrowStatusWrapper* status, const FTSLogRanges& logIds = FTSLogRanges());
         void rollback(Firebird::ThrowStatusWrapper* status);
         void close(Firebird::ThrowStatusWrapper* status);
 
+        /// <summary>
+        /// Makes the changes visible to searches without committing them and closing the near-real-time writer.
+        /// </summary>
+        void publish(Firebird::ThrowStatusWrapper* status);
+
+        /// <summary>
+        /// Returns the FTS$LOG entries contained in the last commit of the index,
+        /// empty if the index is written by an already open near-real-time writer.
+        /// </summary>
+        const FTSLogRanges& committedLogIds() const
+        {
+            return m_committedLogIds;
+        }
+
 
         Lucene::IndexWriterPtr getIndexWriter() { 
             return m_indexWriter;
@@ -92,24 +201,65 @@ namespace LuceneUDR
         {
             return m_ftsIndex.keyFieldType;
         }
+
+        FTSMetadata::FTSKeyEncoding keyEncoding() const
+        {
+            return m_keyEncoding;
+        }
     private:
+        Lucene::String makeKeyTerm(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            const FTSMetadata::FbFieldInfo& field
+        );
+
         Lucene::DocumentPtr makeDocument(
             Firebird::ThrowStatusWrapper* status,
             Firebird::IAttachment* att,
             Firebird::ITransaction* tra
         );
+
+        void queueUpdate(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            const Lucene::String& keyTerm,
+            std::string_view changeType
+        );
+
+        void putBinaryKey(const unsigned char* key, ISC_USHORT keyLength);
     private:
+        struct SortableField
+        {
+            size_t fieldIndex;
+            Lucene::String sortFieldName;
+            FTSMetadata::FTSSortType sortType;
+        };
+
         Firebird::IMaster* m_master { nullptr };
         FTSMetadata::FTSIndex m_ftsIndex;
         FTSMetadata::FbFieldsInfo m_fields;
         FTSMetadata::FbFieldsInfo m_params;
+        std::vector<SortableField> m_sortableFields;
         std::filesystem::path m_indexDirectoryPath;
         Firebird::AutoRelease<Firebird::IStatement> m_stmtExtractRecord;
         Firebird::AutoRelease<Firebird::IMessageMetadata> m_inMetaExtractRecord;
         Firebird::AutoRelease<Firebird::IMessageMetadata> m_outMetaExtractRecord;
         std::vector<unsigned char> m_outputBuffer;
+        // keys of the queued changes: input message of the statement and the change types by key terms
+        std::vector<unsigned char> m_inputBuffer;
+        std::vector<unsigned> m_keyOffsets;
+        std::vector<unsigned> m_keyNullOffsets;
+        std::unordered_map<Lucene::String, char> m_pendingUpdates;
+        unsigned int m_pendingCount{ 0 };
+        size_t m_keyFieldIndex{ 0 };
         Lucene::IndexWriterPtr m_indexWriter;
+        FTSWriterPtr m_nrtWriter;
+        bool m_changed{ false };
+        FTSLogRanges m_committedLogIds;
         Lucene::String m_unicodeKeyFieldName; 
+        FTSMetadata::FTSKeyEncoding m_keyEncoding{ FTSMetadata::FTSKeyEncoding::TEXT };
     };
 
     FTSPreparedIndex prepareFtsIndex(
@@ -120,7 +270,8 @@ namespace LuceneUDR
             unsigned int sqlDialect,
             FTSMetadata::FTSIndex&& ftsIndex,
             const std::filesystem::path& ftsDirectoryPath,
-            bool whereKey = false   
+            bool whereKey = false,
+            bool nearRealTime = false
     );
 
 }
@@ -0,0 +1,64 @@
+/**
+ *  Unsorted stream of search hits.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "FTSHitStream.h"
+
+#include "Scorer.h"
+#include "Weight.h"
+
+using namespace Lucene;
+
+namespace LuceneUDR
+{
+
+    FTSHitStream::FTSHitStream(
+        const SearcherPtr& searcher,
+        const QueryPtr& query,
+        const Collection<IndexReaderPtr>& segmentReaders,
+        const std::vector<int32_t>& docStarts,
+        double minScore
+    )
+        : m_weight(query->weight(searcher))
+        , m_segmentReaders(segmentReaders)
+        , m_docStarts(docStarts)
+        , m_minScore(minScore)
+    {
+    }
+
+    bool FTSHitStream::next()
+    {
+        while (m_segment < m_docStarts.size()) {
+            if (!m_scorer) {
+                // documents are scored in order and not by the top scorer, so nextDoc() can be used
+                m_scorer = m_weight->scorer(m_segmentReaders[static_cast<int32_t>(m_segment)], true, false);
+            }
+            if (m_scorer) {
+                auto doc = m_scorer->nextDoc();
+                while (doc != DocIdSetIterator::NO_MORE_DOCS) {
+                    const double score = m_scorer->score();
+                    if (score >= m_minScore) {
+                        m_doc = m_docStarts[m_segment] + doc;
+                        m_score = score;
+                        return true;
+                    }
+                    doc = m_scorer->nextDoc();
+                }
+            }
+            // the segment is exhausted or has no matches
+            m_scorer.reset();
+            ++m_segment;
+        }
+        return false;
+    }
+
+}
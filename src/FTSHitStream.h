@@ -0,0 +1,94 @@
+#ifndef FTS_HIT_STREAM_H
+#define FTS_HIT_STREAM_H
+
+/**
+ *  Unsorted stream of search hits.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <limits>
+#include <vector>
+
+#include "LuceneHeaders.h"
+
+namespace LuceneUDR
+{
+
+    /// <summary>
+    /// Stream of all hits of a query in index order.
+    ///
+    /// Hits are taken from the scorer of one segment at a time,
+    /// so the memory does not depend on the number of hits.
+    /// Hits are not sorted by score. Hits with a score less than the minimum are skipped.
+    /// </summary>
+    class FTSHitStream final
+    {
+    public:
+        FTSHitStream() = delete;
+
+        /// <summary>
+        /// Creates a stream of hits.
+        /// </summary>
+        ///
+        /// <param name="searcher">Index searcher.</param>
+        /// <param name="query">Search query.</param>
+        /// <param name="segmentReaders">Segment readers of the index in index order.</param>
+        /// <param name="docStarts">Number of the first document of each segment.</param>
+        /// <param name="minScore">Minimum score of a hit.</param>
+        FTSHitStream(
+            const Lucene::SearcherPtr& searcher,
+            const Lucene::QueryPtr& query,
+            const Lucene::Collection<Lucene::IndexReaderPtr>& segmentReaders,
+            const std::vector<int32_t>& docStarts,
+            double minScore = std::numeric_limits<double>::lowest()
+        );
+
+        // non-copyable
+        FTSHitStream(const FTSHitStream& rhs) = delete;
+        FTSHitStream& operator=(const FTSHitStream& rhs) = delete;
+
+        /// <summary>
+        /// Moves to the next hit.
+        /// </summary>
+        ///
+        /// <returns>Returns false if there are no more hits.</returns>
+        bool next();
+
+        /// <summary>
+        /// Returns the document number of the current hit.
+        /// </summary>
+        int32_t doc() const
+        {
+            return m_doc;
+        }
+
+        /// <summary>
+        /// Returns the score of the current hit.
+        /// </summary>
+        double score() const
+        {
+            return m_score;
+        }
+
+    private:
+        Lucene::WeightPtr m_weight;
+        Lucene::Collection<Lucene::IndexReaderPtr> m_segmentReaders;
+        std::vector<int32_t> m_docStarts;
+        double m_minScore;
+        size_t m_segment = 0;
+        Lucene::ScorerPtr m_scorer;
+        int32_t m_doc = -1;
+        double m_score = 0.0;
+    };
+
+}
+
+#endif // FTS_HIT_STREAM_H
@@ -54,7 +54,11 @@ SELECT
   FTS$RELATION_NAME, 
   FTS$ANALYZER, 
   FTS$DESCRIPTION, 
-  FTS$INDEX_STATUS
+  FTS$INDEX_STATUS,
+  FTS$KEY_ENCODING,
+  FTS$PARALLELISM,
+  FTS$STORAGE,
+  FTS$MERGE_FACTOR
 FROM FTS$INDICES
 WHERE FTS$INDEX_NAME = ?
 )SQL";
@@ -65,7 +69,11 @@ SELECT
   FTS$RELATION_NAME, 
   FTS$ANALYZER, 
   FTS$DESCRIPTION, 
-  FTS$INDEX_STATUS
+  FTS$INDEX_STATUS,
+  FTS$KEY_ENCODING,
+  FTS$PARALLELISM,
+  FTS$STORAGE,
+  FTS$MERGE_FACTOR
 FROM FTS$INDICES
 ORDER BY FTS$INDEX_NAME
 )SQL";
@@ -78,6 +86,7 @@ SELECT
   FTS$INDEX_SEGMENTS.FTS$FIELD_NAME,
   FTS$INDEX_SEGMENTS.FTS$KEY,
   FTS$INDEX_SEGMENTS.FTS$BOOST,
+  FTS$INDEX_SEGMENTS.FTS$SORTABLE,
   (RF.RDB$FIELD_NAME IS NOT NULL OR RF.RDB$FIELD_NAME = 'RDB$DB_KEY') AS FIELD_EXISTS
 FROM FTS$INDICES
 JOIN FTS$INDEX_SEGMENTS
@@ -119,6 +128,12 @@ WHERE FTS$INDEX_NAME = ? AND FTS$FIELD_NAME = ?
 UPDATE FTS$INDEX_SEGMENTS
 SET FTS$BOOST = ?
 WHERE FTS$INDEX_NAME = ? AND FTS$FIELD_NAME = ?
+)SQL";
+
+    constexpr const char* SQL_FTS_SET_INDEX_FIELD_SORTABLE = R"SQL(
+UPDATE FTS$INDEX_SEGMENTS
+SET FTS$SORTABLE = ?
+WHERE FTS$INDEX_NAME = ? AND FTS$FIELD_NAME = ?
 )SQL";
 
     constexpr const char* SQL_HAS_INDEX_BY_ANALYZER = R"SQL(
@@ -131,6 +146,13 @@ WHERE FTS$ANALYZER = ?
 SELECT FTS$INDEX_NAME
 FROM FTS$INDICES
 WHERE FTS$ANALYZER = ? AND FTS$INDEX_STATUS = 'C'
+)SQL";
+
+    constexpr const char* SQL_FTS_WARMUP_QUERIES = R"SQL(
+SELECT FTS$QUERY
+FROM FTS$WARMUP_QUERIES
+WHERE FTS$INDEX_NAME = ?
+ORDER BY FTS$QUERY_ID
 )SQL";
 
 }
@@ -144,6 +166,7 @@ namespace FTSMetadata
         bool key,
         double boost,
         bool boostNull,
+        bool sortable,
         bool fieldExists
     )
         : indexName_(indexName)
@@ -151,6 +174,7 @@ namespace FTSMetadata
         , key_(key)
         , boost_(boost)
         , boostNull_(boostNull)
+        , sortable_(sortable)
         , fieldExists_(fieldExists)
     {
     }
@@ -178,6 +202,10 @@ namespace FTSMetadata
         , status(record->indexStatus.str, record->indexStatus.length)
         , segments()
         , keyFieldType{ FTSKeyType::NONE }
+        , keyEncoding{ FTSKeyEncodingFromString(string_view(record->keyEncoding.str, record->keyEncoding.length)) }
+        , parallelism{ record->parallelismNull ? 1 : std::max<int>(record->parallelism, 1) }
+        , storage{ FTSStorageFromString(string_view(record->storage.str, record->storage.length)) }
+        , mergeFactor{ record->mergeFactorNull ? 10 : std::max<int>(record->mergeFactor, 2) }
     {
     }
 
@@ -193,7 +221,8 @@ namespace FTSMetadata
     string FTSIndex::buildSqlSelectFieldValues(
         ThrowStatusWrapper* status,
         unsigned int sqlDialect,
-        bool whereKey) const
+        bool whereKey,
+        unsigned int keyCount) const
     {
         auto iKeySegment = findKey();
         if (iKeySegment == segments.end()) {
@@ -214,7 +243,14 @@ namespace FTSMetadata
         }
         s += "\nFROM " + escapeMetaName(sqlDialect, relationName);
         s += "\nWHERE ";
-        if (whereKey) {
+        if (whereKey && keyCount > 1) {
+            s += escapeMetaName(sqlDialect, keyFieldName) + " IN (?";
+            for (unsigned int i = 1; i < keyCount; i++) {
+                s += ", ?";
+            }
+            s += ")";
+        }
+        else if (whereKey) {
             s += escapeMetaName(sqlDialect, keyFieldName) + " = ?";
         }
         else {
@@ -603,6 +639,7 @@ namespace FTSMetadata
             (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
             (FB_BOOLEAN, key)
             (FB_DOUBLE, boost)
+            (FB_BOOLEAN, sortable)
             (FB_BOOLEAN, fieldExists)
         ) output(status, m_master);
 
@@ -644,6 +681,7 @@ namespace FTSMetadata
                 static_cast<bool>(output->key),
                 output->boost,
                 static_cast<bool>(output->boostNull),
+                static_cast<bool>(output->sortable),
                 fieldExists
             );
         }
@@ -915,6 +953,83 @@ namespace FTSMetadata
         setIndexStatus(status, att, tra, sqlDialect, indexName, "U");
     }
 
+    /// <summary>
+    /// Sets whether the search results can be sorted by the index field.
+    /// </summary>
+    /// 
+    /// <param name="status">Firebird status</param>
+    /// <param name="att">Firebird attachment</param>
+    /// <param name="tra">Firebird transaction</param>
+    /// <param name="sqlDialect">SQL dialect</param>
+    /// <param name="indexName">Index name</param>
+    /// <param name="fieldName">Field name</param>
+    /// <param name="sortable">Sortable flag</param>
+    void FTSIndexRepository::setIndexFieldSortable(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        std::string_view indexName,
+        std::string_view fieldName,
+        bool sortable)
+    {
+        FB_MESSAGE(Input, ThrowStatusWrapper,
+            (FB_BOOLEAN, sortable)
+            (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+            (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
+        ) input(status, m_master);
+
+        input.clear();
+
+        input->indexName.length = static_cast<ISC_USHORT>(indexName.length());
+        indexName.copy(input->indexName.str, input->indexName.length);
+
+        input->fieldName.length = static_cast<ISC_USHORT>(fieldName.length());
+        fieldName.copy(input->fieldName.str, input->fieldName.length);
+
+        input->sortable = sortable;
+
+        const auto ftsIndex = getIndex(status, att, tra, sqlDialect, indexName, true);
+
+        // Checking whether the field exists in the index.
+        const auto iSegment = ftsIndex.findSegment(std::string(fieldName));
+        if (iSegment == ftsIndex.segments.cend()) {
+            std::string sIndexName{ indexName };
+            std::string sFieldName{ fieldName };
+            throwException(status, R"(Field "%s" not exists in index "%s")", sFieldName.c_str(), sIndexName.c_str());
+        }
+
+        if (sortable) {
+            // the key and BLOB fields have no single comparable value
+            if (iSegment->isKey()) {
+                std::string sFieldName{ fieldName };
+                throwException(status, R"(The key field "%s" can not be sortable)", sFieldName.c_str());
+            }
+            RelationHelperPtr relationHelper(std::make_unique<RelationHelper>(m_master));
+            const auto fieldInfo = relationHelper->getField(status, att, tra, sqlDialect, ftsIndex.relationName, fieldName);
+            if (fieldInfo.isBlob()) {
+                std::string sFieldName{ fieldName };
+                throwException(status, R"(BLOB field "%s" can not be sortable)", sFieldName.c_str());
+            }
+        }
+
+        att->execute(
+            status,
+            tra,
+            0,
+            SQL_FTS_SET_INDEX_FIELD_SORTABLE,
+            sqlDialect,
+            input.getMetadata(),
+            input.getData(),
+            nullptr,
+            nullptr
+        );
+        if (ftsIndex.status != "N" && iSegment->isSortable() != sortable) {
+            // the sort values are written when the index is rebuilt
+            setIndexStatus(status, att, tra, sqlDialect, indexName, "U");
+        }
+    }
+
     /// <summary>
     /// Checks for the existence of a field (segment) in a full-text index. 
     /// </summary>
@@ -1070,4 +1185,53 @@ namespace FTSMetadata
         return indexNames;
     }
 
+    std::vector<std::string> FTSIndexRepository::getWarmupQueries(
+        ThrowStatusWrapper* status,
+        IAttachment* att,
+        ITransaction* tra,
+        unsigned int sqlDialect,
+        std::string_view indexName)
+    {
+        FB_MESSAGE(Input, ThrowStatusWrapper,
+            (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        ) input(status, m_master);
+
+        FB_MESSAGE(Output, ThrowStatusWrapper,
+            (FB_INTL_VARCHAR(32765, CS_UTF8), query)
+        ) output(status, m_master);
+
+        input.clear();
+
+        input->indexName.length = static_cast<ISC_USHORT>(indexName.length());
+        indexName.copy(input->indexName.str, input->indexName.length);
+
+        std::vector<std::string> queries;
+
+        AutoRelease<IStatement> stmt(att->prepare(
+            status,
+            tra,
+            0,
+            SQL_FTS_WARMUP_QUERIES,
+            sqlDialect,
+            IStatement::PREPARE_PREFETCH_NONE
+        ));
+
+        AutoRelease<IResultSet> rs(stmt->openCursor(
+            status,
+            tra,
+            input.getMetadata(),
+            input.getData(),
+            output.getMetadata(),
+            0
+        ));
+
+        while (rs->fetchNext(status, output.getData()) == IStatus::RESULT_OK) {
+            queries.emplace_back(output->query.str, output->query.length);
+        }
+        rs->close(status);
+        rs.release();
+
+        return queries;
+    }
+
 }
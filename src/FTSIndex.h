@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "LuceneUdr.h"
 
@@ -35,6 +36,10 @@ namespace FTSMetadata
         (FB_INTL_VARCHAR(252, CS_UTF8), analyzer)
         (FB_BLOB, description)
         (FB_INTL_VARCHAR(4, CS_UTF8), indexStatus)
+        (FB_INTL_VARCHAR(40, CS_UTF8), keyEncoding)
+        (FB_SMALLINT, parallelism)
+        (FB_INTL_VARCHAR(40, CS_UTF8), storage)
+        (FB_SMALLINT, mergeFactor)
     );
 
     enum class FTSKeyType {NONE, DB_KEY, INT_ID, UUID};
@@ -54,6 +59,56 @@ namespace FTSMetadata
         return keyFieldType;
     }
 
+    /// <summary>
+    /// Format of the key field terms in the index.
+    ///
+    /// TEXT - hex string for DB_KEY and UUID, decimal string for INT_ID;
+    /// BINARY - one character per byte for DB_KEY and UUID, trie-encoded number for INT_ID.
+    /// </summary>
+    enum class FTSKeyEncoding {TEXT, BINARY};
+
+    inline FTSKeyEncoding FTSKeyEncodingFromString(std::string_view sKeyEncoding)
+    {
+        if (sKeyEncoding == "BINARY") {
+            return FTSKeyEncoding::BINARY;
+        }
+        return FTSKeyEncoding::TEXT;
+    }
+
+    inline const char* FTSKeyEncodingToString(FTSKeyEncoding keyEncoding)
+    {
+        return keyEncoding == FTSKeyEncoding::BINARY ? "BINARY" : "TEXT";
+    }
+
+    /// <summary>
+    /// I/O strategy of the index directory.
+    ///
+    /// FS - buffered reads of the index files;
+    /// MMAP - memory-mapped index files;
+    /// RAM - searches read a copy of the index loaded into memory, changes are written to the disk.
+    /// </summary>
+    enum class FTSStorage {FS, MMAP, RAM};
+
+    inline FTSStorage FTSStorageFromString(std::string_view sStorage)
+    {
+        if (sStorage == "MMAP") {
+            return FTSStorage::MMAP;
+        }
+        if (sStorage == "RAM") {
+            return FTSStorage::RAM;
+        }
+        return FTSStorage::FS;
+    }
+
+    /// <summary>
+    /// Order of the values of a sortable index field.
+    ///
+    /// STRING - lexicographic order of the text value;
+    /// LONG - numeric order of integer fields;
+    /// DOUBLE - numeric order of the other numeric fields.
+    /// </summary>
+    enum class FTSSortType {STRING, LONG, DOUBLE};
+
     class FTSIndexSegment;
 
     using FTSIndexSegmentList = std::list<FTSIndexSegment>;
@@ -74,6 +129,10 @@ namespace FTSMetadata
         FTSIndexSegmentList segments;
 
         FTSKeyType keyFieldType{ FTSKeyType::NONE };
+        FTSKeyEncoding keyEncoding{ FTSKeyEncoding::BINARY }; // encoding of new and rebuilt indexes
+        int parallelism{ 1 }; // max number of threads searching the segments of the index
+        FTSStorage storage{ FTSStorage::FS }; // I/O strategy of the index directory
+        int mergeFactor{ 10 }; // number of segments of similar size merged into one by the updates
     public: 
 
         FTSIndex() = default;
@@ -97,7 +156,8 @@ namespace FTSMetadata
         std::string buildSqlSelectFieldValues(
             Firebird::ThrowStatusWrapper* status,
             unsigned int sqlDialect,
-            bool whereKey = false
+            bool whereKey = false,
+            unsigned int keyCount = 1
         ) const;
     };
 
@@ -119,6 +179,7 @@ namespace FTSMetadata
             bool key,
             double boost,
             bool boostNull,
+            bool sortable,
             bool fieldExists
         );
 
@@ -146,6 +207,10 @@ namespace FTSMetadata
             return boostNull_;
         }
 
+        bool isSortable() const {
+            return sortable_;
+        }
+
         bool isFieldExists() const {
             return fieldExists_;
         }
@@ -155,6 +220,7 @@ namespace FTSMetadata
         bool key_ = false;
         double boost_ = 1.0;
         bool boostNull_ = true;
+        bool sortable_ = false;
         bool fieldExists_ = false;
     };
 
@@ -403,6 +469,26 @@ namespace FTSMetadata
             double boost,
             bool boostNull = false);
 
+        /// <summary>
+        /// Sets whether the search results can be sorted by the index field.
+        /// </summary>
+        /// 
+        /// <param name="status">Firebird status</param>
+        /// <param name="att">Firebird attachment</param>
+        /// <param name="tra">Firebird transaction</param>
+        /// <param name="sqlDialect">SQL dialect</param>
+        /// <param name="indexName">Index name</param>
+        /// <param name="fieldName">Field name</param>
+        /// <param name="sortable">Sortable flag</param>
+        void setIndexFieldSortable(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            unsigned int sqlDialect,
+            std::string_view indexName,
+            std::string_view fieldName,
+            bool sortable);
+
 
         /// <summary>
         /// Checks for the existence of a field (segment) in a full-text index. 
@@ -439,6 +525,24 @@ namespace FTSMetadata
             unsigned int sqlDialect,
             std::string_view analyzerName
         );
+
+        /// <summary>
+        /// Returns the warm-up queries of the full-text index.
+        /// </summary>
+        /// 
+        /// <param name="status">Firebird status</param>
+        /// <param name="att">Firebird attachment</param>
+        /// <param name="tra">Firebird transaction</param>
+        /// <param name="sqlDialect">SQL dialect</param>
+        /// <param name="indexName">Index name</param>
+        /// <returns>Queries in the order they were added</returns>
+        std::vector<std::string> getWarmupQueries(
+            Firebird::ThrowStatusWrapper* status,
+            Firebird::IAttachment* att,
+            Firebird::ITransaction* tra,
+            unsigned int sqlDialect,
+            std::string_view indexName
+        );
     };
     using FTSIndexRepositoryPtr = std::unique_ptr<FTSIndexRepository>;
 
@@ -0,0 +1,100 @@
+/**
+ *  Ranges of FTS$LOG identifiers.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "FTSLogRanges.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+
+namespace LuceneUDR
+{
+
+    void FTSLogRanges::add(int64_t id)
+    {
+        addRange(id, id);
+    }
+
+    void FTSLogRanges::add(const FTSLogRanges& other)
+    {
+        for (const auto& [first, last] : other.m_ranges) {
+            addRange(first, last);
+        }
+    }
+
+    bool FTSLogRanges::contains(int64_t id) const
+    {
+        // the range that starts at or before the identifier
+        auto it = m_ranges.upper_bound(id);
+        if (it == m_ranges.begin()) {
+            return false;
+        }
+        return id <= std::prev(it)->second;
+    }
+
+    std::string FTSLogRanges::toString() const
+    {
+        std::string text;
+        for (const auto& [first, last] : m_ranges) {
+            if (!text.empty()) {
+                text += ',';
+            }
+            text += std::to_string(first);
+            text += ':';
+            text += std::to_string(last);
+        }
+        return text;
+    }
+
+    FTSLogRanges FTSLogRanges::fromString(const std::string& text)
+    {
+        FTSLogRanges ranges;
+        const char* p = text.c_str();
+        while (*p) {
+            char* end = nullptr;
+            const auto first = static_cast<int64_t>(std::strtoll(p, &end, 10));
+            if (end == p || *end != ':') {
+                return {};
+            }
+            p = end + 1;
+            const auto last = static_cast<int64_t>(std::strtoll(p, &end, 10));
+            if (end == p || (*end != ',' && *end != '\0') || last < first) {
+                return {};
+            }
+            ranges.addRange(first, last);
+            p = (*end == ',') ? end + 1 : end;
+        }
+        return ranges;
+    }
+
+    void FTSLogRanges::addRange(int64_t first, int64_t last)
+    {
+        // join the ranges that overlap or adjoin the new one
+        auto it = m_ranges.upper_bound(first);
+        if (it != m_ranges.begin()) {
+            const auto prev = std::prev(it);
+            if (prev->second >= first || prev->second == first - 1) {
+                first = prev->first;
+                last = std::max(last, prev->second);
+                it = m_ranges.erase(prev);
+            }
+        }
+        while (it != m_ranges.end() && (it->first <= last || (last < std::numeric_limits<int64_t>::max() && it->first == last + 1))) {
+            last = std::max(last, it->second);
+            it = m_ranges.erase(it);
+        }
+        m_ranges.emplace_hint(it, first, last);
+    }
+
+}
@@ -0,0 +1,97 @@
+#ifndef FTS_LOG_RANGES_H
+#define FTS_LOG_RANGES_H
+
+/**
+ *  Ranges of FTS$LOG identifiers.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace LuceneUDR
+{
+
+    /// <summary>
+    /// Set of FTS$LOG identifiers stored as ranges of consecutive identifiers.
+    ///
+    /// The identifiers are given out in the order of insertion, not of commit,
+    /// so an identifier missing from the set may belong to a log record that was not yet visible when the log was read.
+    /// Only the identifiers in the set may be deleted from the log.
+    /// </summary>
+    class FTSLogRanges final
+    {
+    public:
+        using RangeMap = std::map<int64_t, int64_t>;
+
+        /// <summary>
+        /// Adds the identifier, neighbouring ranges are joined.
+        /// </summary>
+        ///
+        /// <param name="id">FTS$LOG identifier.</param>
+        void add(int64_t id);
+
+        /// <summary>
+        /// Adds all identifiers of the other set.
+        /// </summary>
+        ///
+        /// <param name="other">Set of FTS$LOG identifiers.</param>
+        void add(const FTSLogRanges& other);
+
+        /// <summary>
+        /// Returns true if the identifier is in the set.
+        /// </summary>
+        ///
+        /// <param name="id">FTS$LOG identifier.</param>
+        bool contains(int64_t id) const;
+
+        bool empty() const
+        {
+            return m_ranges.empty();
+        }
+
+        void clear()
+        {
+            m_ranges.clear();
+        }
+
+        /// <summary>
+        /// Returns the ranges: first and last identifier of each range in ascending order.
+        /// </summary>
+        const RangeMap& ranges() const
+        {
+            return m_ranges;
+        }
+
+        /// <summary>
+        /// Returns the set as text: "first:last" ranges separated by commas.
+        /// </summary>
+        std::string toString() const;
+
+        /// <summary>
+        /// Parses the set written by toString.
+        /// </summary>
+        ///
+        /// <param name="text">Ranges of identifiers as text.</param>
+        ///
+        /// <returns>Set of identifiers, empty if the text is not valid.</returns>
+        static FTSLogRanges fromString(const std::string& text);
+
+    private:
+        void addRange(int64_t first, int64_t last);
+
+        RangeMap m_ranges;
+    };
+
+}
+
+#endif // FTS_LOG_RANGES_H
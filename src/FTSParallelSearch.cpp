@@ -0,0 +1,104 @@
+/**
+ *  Search of the index segments on the worker pool.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "FTSParallelSearch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+#include "MinScoreCollector.h"
+#include "TimeLimitingCollector.h"
+
+using namespace Lucene;
+
+namespace LuceneUDR
+{
+
+    std::vector<size_t> splitSegments(const Collection<IndexReaderPtr>& segmentReaders, size_t groupCount)
+    {
+        const auto segmentCount = static_cast<size_t>(segmentReaders.size());
+        groupCount = std::max<size_t>(std::min(groupCount, segmentCount), 1);
+
+        int64_t totalDocs = 0;
+        for (const auto& segmentReader : segmentReaders) {
+            totalDocs += segmentReader->maxDoc();
+        }
+
+        std::vector<size_t> bounds{ 0 };
+        int64_t docs = 0;
+        for (size_t i = 0; i < segmentCount; i++) {
+            docs += segmentReaders[static_cast<int32_t>(i)]->maxDoc();
+            // close the group when it has its share of documents,
+            // but leave at least one segment for each of the remaining groups
+            const auto group = bounds.size();
+            const bool lastSegment = (i + 1 == segmentCount);
+            if (lastSegment ||
+                (group < groupCount && docs * static_cast<int64_t>(groupCount) >= totalDocs * static_cast<int64_t>(group)) ||
+                (segmentCount - i - 1 == groupCount - group))
+            {
+                bounds.push_back(i + 1);
+            }
+        }
+        return bounds;
+    }
+
+    CollectorPtr limitCollector(const CollectorPtr& collector, double minScore, int64_t timeoutMs)
+    {
+        CollectorPtr target = collector;
+        if (minScore > std::numeric_limits<double>::lowest()) {
+            target = newLucene<MinScoreCollector>(target, minScore);
+        }
+        if (timeoutMs > 0) {
+            // the constructor starts the shared timer thread of the time limits on first use,
+            // which is not safe to do from concurrent searches
+            static std::mutex timerMutex;
+            std::lock_guard<std::mutex> lock(timerMutex);
+            target = newLucene<TimeLimitingCollector>(target, timeoutMs);
+        }
+        return target;
+    }
+
+    TopDocsPtr mergeTopDocs(const std::vector<TopDocsPtr>& groupDocs, int32_t start, int32_t howMany)
+    {
+        int32_t totalHits = 0;
+        double maxScore = std::numeric_limits<double>::quiet_NaN();
+        std::vector<ScoreDocPtr> hits;
+        for (const auto& docs : groupDocs) {
+            totalHits += docs->totalHits;
+            if (docs->scoreDocs.empty()) {
+                continue;
+            }
+            if (std::isnan(maxScore) || docs->maxScore > maxScore) {
+                maxScore = docs->maxScore;
+            }
+            hits.insert(hits.end(), docs->scoreDocs.begin(), docs->scoreDocs.end());
+        }
+
+        std::sort(hits.begin(), hits.end(), [](const ScoreDocPtr& a, const ScoreDocPtr& b) {
+            return (a->score > b->score) || (a->score == b->score && a->doc < b->doc);
+        });
+
+        const auto size = static_cast<int32_t>(hits.size());
+        start = std::min(std::max(start, 0), size);
+        howMany = std::min(std::max(howMany, 0), size - start);
+
+        auto scoreDocs = Collection<ScoreDocPtr>::newInstance(howMany);
+        for (int32_t i = 0; i < howMany; i++) {
+            scoreDocs[i] = hits[start + i];
+        }
+        return newLucene<TopDocs>(totalHits, scoreDocs, maxScore);
+    }
+
+}
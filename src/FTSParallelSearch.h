@@ -0,0 +1,167 @@
+#ifndef FTS_PARALLEL_SEARCH_H
+#define FTS_PARALLEL_SEARCH_H
+
+/**
+ *  Search of the index segments on the worker pool.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <chrono>
+#include <exception>
+#include <future>
+#include <utility>
+#include <vector>
+
+#include "LuceneHeaders.h"
+#include "Scorer.h"
+#include "Weight.h"
+#include "WorkerPool.h"
+
+namespace LuceneUDR
+{
+
+    /// <summary>
+    /// Splits the segments into groups of neighbouring segments with close numbers of documents.
+    /// </summary>
+    ///
+    /// <param name="segmentReaders">Segment readers of the index in index order.</param>
+    /// <param name="groupCount">Max number of groups.</param>
+    ///
+    /// <returns>Number of the first segment of each group followed by the number of segments.</returns>
+    std::vector<size_t> splitSegments(const Lucene::Collection<Lucene::IndexReaderPtr>& segmentReaders, size_t groupCount);
+
+    /// <summary>
+    /// Wraps the collector of a search with the limits of the search.
+    /// The time limit starts when the collector is created.
+    /// </summary>
+    ///
+    /// <param name="collector">Collector of the top hits.</param>
+    /// <param name="minScore">Hits with a lower score are dropped, the lowest double value - no cutoff.</param>
+    /// <param name="timeoutMs">Time budget in milliseconds, 0 - no limit.</param>
+    ///
+    /// <returns>Collector passed to the scorers.</returns>
+    Lucene::CollectorPtr limitCollector(const Lucene::CollectorPtr& collector, double minScore, int64_t timeoutMs);
+
+    /// <summary>
+    /// Merges the top hits of the segment groups.
+    ///
+    /// Hits are ranked by score, ties are resolved by the document number,
+    /// so the result is the same as of the search on one thread.
+    /// </summary>
+    ///
+    /// <param name="groupDocs">Top hits of each group.</param>
+    /// <param name="start">Number of hits to skip.</param>
+    /// <param name="howMany">Max number of hits to return.</param>
+    ///
+    /// <returns>Merged top hits.</returns>
+    Lucene::TopDocsPtr mergeTopDocs(const std::vector<Lucene::TopDocsPtr>& groupDocs, int32_t start, int32_t howMany);
+
+    /// <summary>
+    /// Searches the groups of segments in parallel on the worker pool.
+    ///
+    /// The query weight and the collectors are created on the calling thread,
+    /// each group of segments is collected by its own collector.
+    /// When the time budget is exhausted, the groups stop collecting and their partial hits are merged.
+    /// </summary>
+    ///
+    /// <param name="searcher">Index searcher.</param>
+    /// <param name="query">Search query.</param>
+    /// <param name="segmentReaders">Segment readers of the index in index order.</param>
+    /// <param name="docStarts">Number of the first document of each segment.</param>
+    /// <param name="parallelism">Max number of groups searched in parallel.</param>
+    /// <param name="start">Number of hits to skip.</param>
+    /// <param name="howMany">Max number of hits to return.</param>
+    /// <param name="minScore">Hits with a lower score are dropped, the lowest double value - no cutoff.</param>
+    /// <param name="timeoutMs">Time budget of the search in milliseconds, 0 - no limit.</param>
+    /// <param name="truncated">Set to true if the search was stopped by the time budget.</param>
+    /// <param name="makeCollector">Creates the collector of start + howMany top hits of a group, called on the calling thread.</param>
+    ///
+    /// <returns>Top hits of the index.</returns>
+    template <class MakeCollector>
+    Lucene::TopDocsPtr parallelSearch(
+        const Lucene::SearcherPtr& searcher,
+        const Lucene::QueryPtr& query,
+        const Lucene::Collection<Lucene::IndexReaderPtr>& segmentReaders,
+        const std::vector<int32_t>& docStarts,
+        size_t parallelism,
+        int32_t start,
+        int32_t howMany,
+        double minScore,
+        int64_t timeoutMs,
+        bool& truncated,
+        MakeCollector makeCollector)
+    {
+        // one deadline for all groups, a group may start after the others
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        const auto bounds = splitSegments(segmentReaders, parallelism);
+        const auto weight = query->weight(searcher);
+        const int32_t numHits = start + howMany;
+
+        // top hits of a group and the flag that the group was stopped by the time budget
+        using GroupResult = std::pair<Lucene::TopDocsPtr, bool>;
+
+        WorkerPool::Batch batch(WorkerPool::instance());
+        std::vector<std::future<GroupResult>> futures;
+        futures.reserve(bounds.size() - 1);
+        for (size_t group = 0; group + 1 < bounds.size(); group++) {
+            // the collectors are created on the calling thread, so the time limits of all groups
+            // start together and the timer of the time limits is never started by a worker
+            auto collector = makeCollector();
+            auto target = limitCollector(collector, minScore, timeoutMs);
+            futures.push_back(batch.submit(
+                [weight, segmentReaders, docStarts, first = bounds[group], last = bounds[group + 1], numHits, timeoutMs, deadline, collector, target]() {
+                    try {
+                        for (size_t i = first; i < last; i++) {
+                            if (timeoutMs > 0 && std::chrono::steady_clock::now() >= deadline) {
+                                return GroupResult(collector->topDocs(0, numHits), true);
+                            }
+                            const auto& segmentReader = segmentReaders[static_cast<int32_t>(i)];
+                            target->setNextReader(segmentReader, docStarts[i]);
+                            auto scorer = weight->scorer(segmentReader, !target->acceptsDocsOutOfOrder(), true);
+                            if (scorer) {
+                                scorer->score(target);
+                            }
+                        }
+                    }
+                    catch (const Lucene::TimeExceededException&) {
+                        return GroupResult(collector->topDocs(0, numHits), true);
+                    }
+                    return GroupResult(collector->topDocs(0, numHits), false);
+                }
+            ));
+        }
+
+        // all tasks are waited for, even if one of them failed
+        std::vector<Lucene::TopDocsPtr> groupDocs;
+        groupDocs.reserve(futures.size());
+        std::exception_ptr error;
+        truncated = false;
+        for (auto& future : futures) {
+            try {
+                auto [docs, groupTruncated] = batch.wait(future);
+                groupDocs.push_back(docs);
+                truncated = truncated || groupTruncated;
+            }
+            catch (...) {
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return mergeTopDocs(groupDocs, start, howMany);
+    }
+
+}
+
+#endif // FTS_PARALLEL_SEARCH_H
@@ -0,0 +1,73 @@
+/**
+ *  Process-wide cache of parsed search queries.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "FTSQueryCache.h"
+
+using namespace Lucene;
+
+namespace LuceneUDR
+{
+
+    FTSQueryCache& FTSQueryCache::instance()
+    {
+        static FTSQueryCache cache(DEFAULT_CAPACITY);
+        return cache;
+    }
+
+    FTSQueryCache::FTSQueryCache(size_t capacity)
+        : m_capacity(capacity)
+    {
+    }
+
+    QueryPtr FTSQueryCache::get(const std::string& key, const AnalyzerPtr& analyzer)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_index.find(key);
+        if (it == m_index.end() || it->second->analyzer != analyzer) {
+            ++m_misses;
+            return nullptr;
+        }
+        ++m_hits;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->query;
+    }
+
+    void FTSQueryCache::put(const std::string& key, const AnalyzerPtr& analyzer, const QueryPtr& query)
+    {
+        if (m_capacity == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            // the query was parsed with the previous version of the analyzer or by a concurrent search
+            it->second->analyzer = analyzer;
+            it->second->query = query;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return;
+        }
+        if (m_entries.size() >= m_capacity) {
+            m_index.erase(m_entries.back().key);
+            m_entries.pop_back();
+        }
+        m_entries.push_front({ key, analyzer, query });
+        m_index.emplace(key, m_entries.begin());
+    }
+
+    FTSCacheStatistics FTSQueryCache::statistics()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return { m_capacity, m_entries.size(), m_hits, m_misses };
+    }
+
+}
@@ -0,0 +1,100 @@
+#ifndef FTS_QUERY_CACHE_H
+#define FTS_QUERY_CACHE_H
+
+/**
+ *  Process-wide cache of parsed search queries.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "LuceneHeaders.h"
+
+namespace LuceneUDR
+{
+
+    /// <summary>
+    /// Counters of a process-wide cache.
+    /// </summary>
+    struct FTSCacheStatistics
+    {
+        size_t capacity = 0;
+        size_t size = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    /// <summary>
+    /// LRU cache of parsed search queries shared by all attachments.
+    ///
+    /// A query is cached together with the analyzer it was parsed with.
+    /// When the analyzer is replaced (for example, its stop words have been changed),
+    /// the cached query is not returned and is parsed again.
+    /// Cached queries are never modified, so they may be used by several searches at the same time.
+    /// </summary>
+    class FTSQueryCache final
+    {
+    public:
+        static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+        static FTSQueryCache& instance();
+
+        explicit FTSQueryCache(size_t capacity);
+
+        // non-copyable
+        FTSQueryCache(const FTSQueryCache& rhs) = delete;
+        FTSQueryCache& operator=(const FTSQueryCache& rhs) = delete;
+
+        /// <summary>
+        /// Returns the cached query.
+        /// </summary>
+        ///
+        /// <param name="key">Key of the query: database, index, fields and query text.</param>
+        /// <param name="analyzer">Analyzer the query must be parsed with.</param>
+        ///
+        /// <returns>Query or nullptr if it is not cached.</returns>
+        Lucene::QueryPtr get(const std::string& key, const Lucene::AnalyzerPtr& analyzer);
+
+        /// <summary>
+        /// Puts the query into the cache, the least recently used query is evicted.
+        /// </summary>
+        ///
+        /// <param name="key">Key of the query: database, index, fields and query text.</param>
+        /// <param name="analyzer">Analyzer the query has been parsed with.</param>
+        /// <param name="query">Parsed query.</param>
+        void put(const std::string& key, const Lucene::AnalyzerPtr& analyzer, const Lucene::QueryPtr& query);
+
+        FTSCacheStatistics statistics();
+
+    private:
+        struct Entry
+        {
+            std::string key;
+            Lucene::AnalyzerPtr analyzer;
+            Lucene::QueryPtr query;
+        };
+        using EntryList = std::list<Entry>;
+
+        std::mutex m_mutex;
+        size_t m_capacity;
+        EntryList m_entries; // most recently used first
+        std::unordered_map<std::string, EntryList::iterator> m_index;
+        uint64_t m_hits = 0;
+        uint64_t m_misses = 0;
+    };
+
+}
+
+#endif // FTS_QUERY_CACHE_H
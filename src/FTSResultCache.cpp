@@ -0,0 +1,135 @@
+/**
+ *  Process-wide cache of top search results.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "FTSResultCache.h"
+
+#include <iterator>
+
+using namespace Lucene;
+
+namespace
+{
+    // approximate memory of a cached hit: the ScoreDoc object and its shared pointer
+    constexpr size_t HIT_MEMORY_SIZE = 64;
+    constexpr size_t ENTRY_MEMORY_SIZE = 256;
+
+    bool sameSnapshot(const std::weak_ptr<LuceneUDR::FTSSearcher>& cached, const LuceneUDR::FTSSearcherPtr& searcher)
+    {
+        // owner comparison does not need the cached snapshot to be alive
+        return !cached.owner_before(searcher) && !searcher.owner_before(cached);
+    }
+}
+
+namespace LuceneUDR
+{
+
+    FTSResultCache& FTSResultCache::instance()
+    {
+        static FTSResultCache cache(DEFAULT_MEMORY_LIMIT);
+        return cache;
+    }
+
+    FTSResultCache::FTSResultCache(size_t memoryLimit)
+        : m_memoryLimit(memoryLimit)
+    {
+    }
+
+    TopDocsPtr FTSResultCache::get(
+        const std::filesystem::path& indexDirectoryPath,
+        const std::string& searchKey,
+        const FTSSearcherPtr& searcher,
+        const QueryPtr& query
+    )
+    {
+        std::string key = indexDirectoryPath.u8string();
+        key += '\0';
+        key += searchKey;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_index.find(key);
+        if (it == m_index.end()) {
+            ++m_misses;
+            return nullptr;
+        }
+        const auto entry = it->second;
+        if (!sameSnapshot(entry->searcher, searcher) || entry->query != query) {
+            // the index has been changed or the query has been parsed again
+            remove(entry);
+            ++m_misses;
+            return nullptr;
+        }
+        ++m_hits;
+        m_entries.splice(m_entries.begin(), m_entries, entry);
+        return entry->docs;
+    }
+
+    void FTSResultCache::put(
+        const std::filesystem::path& indexDirectoryPath,
+        const std::string& searchKey,
+        const FTSSearcherPtr& searcher,
+        const QueryPtr& query,
+        const TopDocsPtr& docs
+    )
+    {
+        std::string indexKey = indexDirectoryPath.u8string();
+        std::string key = indexKey;
+        key += '\0';
+        key += searchKey;
+
+        const size_t memorySize = ENTRY_MEMORY_SIZE + 2 * key.size() +
+            static_cast<size_t>(docs->scoreDocs.size()) * HIT_MEMORY_SIZE;
+        if (memorySize > m_memoryLimit) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            remove(it->second);
+        }
+        while (m_memorySize + memorySize > m_memoryLimit) {
+            remove(std::prev(m_entries.end()));
+        }
+        m_entries.push_front({ key, std::move(indexKey), searcher, query, docs, memorySize });
+        m_index.emplace(std::move(key), m_entries.begin());
+        m_memorySize += memorySize;
+    }
+
+    void FTSResultCache::invalidate(const std::filesystem::path& indexDirectoryPath)
+    {
+        const std::string indexKey = indexDirectoryPath.u8string();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_entries.begin(); it != m_entries.end(); ) {
+            const auto next = std::next(it);
+            if (it->indexKey == indexKey) {
+                remove(it);
+            }
+            it = next;
+        }
+    }
+
+    FTSCacheStatistics FTSResultCache::statistics()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return { m_memoryLimit, m_memorySize, m_hits, m_misses };
+    }
+
+    void FTSResultCache::remove(EntryList::iterator it)
+    {
+        m_memorySize -= it->memorySize;
+        m_index.erase(it->key);
+        m_entries.erase(it);
+    }
+
+}
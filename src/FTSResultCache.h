@@ -0,0 +1,121 @@
+#ifndef FTS_RESULT_CACHE_H
+#define FTS_RESULT_CACHE_H
+
+/**
+ *  Process-wide cache of top search results.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "FTSQueryCache.h"
+#include "FTSSearcherCache.h"
+#include "LuceneHeaders.h"
+
+namespace LuceneUDR
+{
+
+    /// <summary>
+    /// LRU cache of top search results shared by all attachments.
+    ///
+    /// The results are document numbers and scores, so they are valid only for the index snapshot
+    /// they were found in. The entries of an index are dropped when its searcher is reopened
+    /// after a commit, and a result is never returned for another snapshot of the index.
+    /// The cache is bounded by the estimated memory of the entries.
+    /// </summary>
+    class FTSResultCache final
+    {
+    public:
+        static constexpr size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+        static FTSResultCache& instance();
+
+        explicit FTSResultCache(size_t memoryLimit);
+
+        // non-copyable
+        FTSResultCache(const FTSResultCache& rhs) = delete;
+        FTSResultCache& operator=(const FTSResultCache& rhs) = delete;
+
+        /// <summary>
+        /// Returns the cached result of the search.
+        /// </summary>
+        ///
+        /// <param name="indexDirectoryPath">Full path to the index directory.</param>
+        /// <param name="searchKey">Key of the search: query text and paging parameters.</param>
+        /// <param name="searcher">Index snapshot the search runs on.</param>
+        /// <param name="query">Parsed query.</param>
+        ///
+        /// <returns>Top hits or nullptr if the result is not cached.</returns>
+        Lucene::TopDocsPtr get(
+            const std::filesystem::path& indexDirectoryPath,
+            const std::string& searchKey,
+            const FTSSearcherPtr& searcher,
+            const Lucene::QueryPtr& query
+        );
+
+        /// <summary>
+        /// Puts the result of the search into the cache.
+        /// </summary>
+        ///
+        /// <param name="indexDirectoryPath">Full path to the index directory.</param>
+        /// <param name="searchKey">Key of the search: query text and paging parameters.</param>
+        /// <param name="searcher">Index snapshot the search ran on.</param>
+        /// <param name="query">Parsed query.</param>
+        /// <param name="docs">Top hits.</param>
+        void put(
+            const std::filesystem::path& indexDirectoryPath,
+            const std::string& searchKey,
+            const FTSSearcherPtr& searcher,
+            const Lucene::QueryPtr& query,
+            const Lucene::TopDocsPtr& docs
+        );
+
+        /// <summary>
+        /// Removes all results of the index.
+        /// </summary>
+        ///
+        /// <param name="indexDirectoryPath">Full path to the index directory.</param>
+        void invalidate(const std::filesystem::path& indexDirectoryPath);
+
+        FTSCacheStatistics statistics();
+
+    private:
+        struct Entry
+        {
+            std::string key;
+            std::string indexKey;
+            std::weak_ptr<FTSSearcher> searcher;
+            Lucene::QueryPtr query;
+            Lucene::TopDocsPtr docs;
+            size_t memorySize;
+        };
+        using EntryList = std::list<Entry>;
+
+        void remove(EntryList::iterator it);
+
+        std::mutex m_mutex;
+        size_t m_memoryLimit;
+        size_t m_memorySize = 0;
+        EntryList m_entries; // most recently used first
+        std::unordered_map<std::string, EntryList::iterator> m_index;
+        uint64_t m_hits = 0;
+        uint64_t m_misses = 0;
+    };
+
+}
+
+#endif // FTS_RESULT_CACHE_H
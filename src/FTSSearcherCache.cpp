@@ -0,0 +1,294 @@
+/**
+ *  Process-wide cache of full-text index searchers.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "FTSSearcherCache.h"
+
+#include <algorithm>
+
+#include "FieldCache.h"
+#include "IndexCommit.h"
+#include "FTSHelper.h"
+#include "FTSResultCache.h"
+
+using namespace Lucene;
+
+namespace
+{
+    constexpr int32_t COPY_BUFFER_SIZE = 64 * 1024;
+
+    void copyFile(const DirectoryPtr& source, const DirectoryPtr& target, const String& fileName)
+    {
+        auto input = source->openInput(fileName);
+        auto output = target->createOutput(fileName);
+        auto buffer = ByteArray::newInstance(COPY_BUFFER_SIZE);
+        for (int64_t remaining = input->length(); remaining > 0; ) {
+            const auto size = static_cast<int32_t>(std::min<int64_t>(remaining, COPY_BUFFER_SIZE));
+            input->readBytes(buffer.get(), 0, size);
+            output->writeBytes(buffer.get(), size);
+            remaining -= size;
+        }
+        output->close();
+        input->close();
+    }
+
+    void gatherSegmentReaders(Collection<IndexReaderPtr>& segmentReaders, const IndexReaderPtr& reader)
+    {
+        const auto subReaders = reader->getSequentialSubReaders();
+        if (!subReaders) {
+            segmentReaders.add(reader);
+            return;
+        }
+        for (const auto& subReader : subReaders) {
+            gatherSegmentReaders(segmentReaders, subReader);
+        }
+    }
+}
+
+namespace LuceneUDR
+{
+
+    FTSSearcher::FTSSearcher(DirectoryPtr directory, IndexReaderPtr reader)
+        : FTSSearcher(directory, reader, getKeyEncoding(reader->getCommitUserData()))
+    {
+    }
+
+    FTSSearcher::FTSSearcher(DirectoryPtr directory, IndexReaderPtr reader, FTSMetadata::FTSKeyEncoding keyEncoding)
+        : m_directory(std::move(directory))
+        , m_reader(std::move(reader))
+        , m_searcher(newLucene<IndexSearcher>(m_reader))
+        , m_segmentReaders(Collection<IndexReaderPtr>::newInstance())
+        , m_docStarts()
+        , m_keyEncoding(keyEncoding)
+    {
+        gatherSegmentReaders(m_segmentReaders, m_reader);
+        m_docStarts.reserve(m_segmentReaders.size());
+        int32_t docStart = 0;
+        for (const auto& segmentReader : m_segmentReaders) {
+            m_docStarts.push_back(docStart);
+            docStart += segmentReader->maxDoc();
+        }
+    }
+
+    FTSSearcher::~FTSSearcher()
+    {
+        try {
+            m_searcher->close();
+            m_reader->close();
+        }
+        catch (const LuceneException&) {
+            // the reader is no longer used, errors on closing are not important
+        }
+    }
+
+    String FTSSearcher::getKey(const String& keyFieldName, int32_t doc)
+    {
+        const auto keyColumn = getKeyColumn(keyFieldName, false);
+        const auto segment = findSegment(doc);
+        return keyColumn->values[segment][doc - m_docStarts[segment]];
+    }
+
+    int64_t FTSSearcher::getIntKey(const String& keyFieldName, int32_t doc)
+    {
+        if (m_keyEncoding == FTSMetadata::FTSKeyEncoding::TEXT) {
+            return keyTermToInt(getKey(keyFieldName, doc), m_keyEncoding);
+        }
+        const auto keyColumn = getKeyColumn(keyFieldName, true);
+        const auto segment = findSegment(doc);
+        return keyColumn->numbers[segment][doc - m_docStarts[segment]];
+    }
+
+    void FTSSearcher::preloadKeys(const String& keyFieldName, bool intKey)
+    {
+        // the same column as getIntKey or getKey reads
+        getKeyColumn(keyFieldName, intKey && m_keyEncoding != FTSMetadata::FTSKeyEncoding::TEXT);
+    }
+
+    size_t FTSSearcher::findSegment(int32_t doc) const
+    {
+        const auto it = std::upper_bound(m_docStarts.begin(), m_docStarts.end(), doc);
+        return static_cast<size_t>(std::distance(m_docStarts.begin(), it) - 1);
+    }
+
+    FTSSearcher::KeyColumnPtr FTSSearcher::getKeyColumn(const String& keyFieldName, bool numeric)
+    {
+        std::lock_guard<std::mutex> lock(m_keyColumnMutex);
+        if (m_keyColumn && m_keyColumn->fieldName == keyFieldName && m_keyColumn->numeric == numeric) {
+            return m_keyColumn;
+        }
+
+        auto keyColumn = std::make_shared<KeyColumn>();
+        keyColumn->fieldName = keyFieldName;
+        keyColumn->numeric = numeric;
+
+        for (const auto& segmentReader : m_segmentReaders) {
+            // FieldCache keeps the values while the segment reader is alive, 
+            // so unchanged segments are not loaded again after reopen
+            if (numeric) {
+                keyColumn->numbers.push_back(
+                    FieldCache::DEFAULT()->getLongs(segmentReader, keyFieldName, FieldCache::NUMERIC_UTILS_LONG_PARSER())
+                );
+            }
+            else {
+                keyColumn->values.push_back(FieldCache::DEFAULT()->getStrings(segmentReader, keyFieldName));
+            }
+        }
+
+        m_keyColumn = keyColumn;
+        return m_keyColumn;
+    }
+
+    FTSSearcherCache& FTSSearcherCache::instance()
+    {
+        static FTSSearcherCache cache;
+        return cache;
+    }
+
+    FTSSearcherPtr FTSSearcherCache::acquire(const std::filesystem::path& indexDirectoryPath, FTSMetadata::FTSStorage storage)
+    {
+        const auto key = indexDirectoryPath.wstring();
+
+        EntryPtr entry;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto& cachedEntry = m_entries[key];
+            if (!cachedEntry) {
+                cachedEntry = std::make_shared<Entry>();
+            }
+            entry = cachedEntry;
+        }
+
+        const auto writer = FTSWriterCache::instance().find(indexDirectoryPath);
+
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        if (writer) {
+            const auto generation = writer->generation();
+            if (!entry->searcher || entry->writer != writer || entry->generation != generation) {
+                try {
+                    // the reader sees the documents buffered in the writer, nothing is committed;
+                    // unchanged segments are shared with the previous reader
+                    auto reader = writer->writer()->getReader();
+                    entry->searcher = std::make_shared<FTSSearcher>(writer->writer()->getDirectory(), reader, writer->keyEncoding());
+                    entry->writer = writer;
+                    entry->generation = generation;
+                    FTSResultCache::instance().invalidate(indexDirectoryPath);
+                }
+                catch (const LuceneException&) {
+                    entry->searcher.reset();
+                    entry->writer.reset();
+                    FTSResultCache::instance().invalidate(indexDirectoryPath);
+                    throw;
+                }
+            }
+            return entry->searcher;
+        }
+        if (entry->writer) {
+            // the near-real-time writer has been closed, its changes are in the last commit
+            entry->searcher.reset();
+            entry->writer.reset();
+            FTSResultCache::instance().invalidate(indexDirectoryPath);
+        }
+        if (entry->searcher && entry->storage != storage) {
+            // the storage of the index has been changed, the index is opened again
+            entry->searcher.reset();
+            entry->diskDirectory.reset();
+            FTSResultCache::instance().invalidate(indexDirectoryPath);
+        }
+        if (entry->searcher) {
+            try {
+                if (storage == FTSMetadata::FTSStorage::RAM) {
+                    // the in-memory copy never changes, it is compared with the last commit on the disk
+                    if (IndexReader::getCurrentVersion(entry->diskDirectory) != entry->diskVersion) {
+                        copyToRam(*entry, entry->diskDirectory);
+                        FTSResultCache::instance().invalidate(indexDirectoryPath);
+                    }
+                    return entry->searcher;
+                }
+                const auto& reader = entry->searcher->reader();
+                if (!reader->isCurrent()) {
+                    // only new and changed segments are opened, the rest are shared with the old reader
+                    auto newReader = reader->reopen();
+                    if (newReader != reader) {
+                        entry->searcher = std::make_shared<FTSSearcher>(entry->searcher->directory(), newReader);
+                        // results of the previous snapshot are no longer valid
+                        FTSResultCache::instance().invalidate(indexDirectoryPath);
+                    }
+                }
+            }
+            catch (const LuceneException&) {
+                // the index was probably deleted or recreated, the next call will open it again
+                entry->searcher.reset();
+                entry->diskDirectory.reset();
+                FTSResultCache::instance().invalidate(indexDirectoryPath);
+                throw;
+            }
+            return entry->searcher;
+        }
+
+        auto directory = openIndexDirectory(indexDirectoryPath, storage);
+        if (!IndexReader::indexExists(directory)) {
+            return nullptr;
+        }
+        entry->storage = storage;
+        if (storage == FTSMetadata::FTSStorage::RAM) {
+            copyToRam(*entry, directory);
+            return entry->searcher;
+        }
+        auto reader = IndexReader::open(directory, true);
+        entry->searcher = std::make_shared<FTSSearcher>(directory, reader);
+        return entry->searcher;
+    }
+
+    void FTSSearcherCache::copyToRam(Entry& entry, const DirectoryPtr& diskDirectory)
+    {
+        for (int attempt = 1; ; attempt++) {
+            try {
+                // only the files of the last commit are copied, the files of a commit are never changed,
+                // but an update or a merge may delete them once a newer commit is made
+                const auto commits = IndexReader::listCommits(diskDirectory);
+                const auto commit = commits[commits.size() - 1];
+                auto ramDirectory = newLucene<RAMDirectory>();
+                for (const auto& fileName : commit->getFileNames()) {
+                    copyFile(diskDirectory, ramDirectory, fileName);
+                }
+                const auto version = commit->getVersion();
+                if (IndexReader::getCurrentVersion(diskDirectory) != version && attempt < MAX_COPY_ATTEMPTS) {
+                    // a newer commit was made during the copy
+                    continue;
+                }
+                auto reader = IndexReader::open(ramDirectory, true);
+                entry.searcher = std::make_shared<FTSSearcher>(ramDirectory, reader);
+                entry.diskDirectory = diskDirectory;
+                entry.diskVersion = version;
+                return;
+            }
+            catch (const LuceneException&) {
+                // a file of the commit was deleted by a newer commit, the newer commit is copied
+                if (attempt >= MAX_COPY_ATTEMPTS) {
+                    throw;
+                }
+            }
+        }
+    }
+
+    void FTSSearcherCache::invalidate(const std::filesystem::path& indexDirectoryPath)
+    {
+        const auto key = indexDirectoryPath.wstring();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_entries.erase(key);
+        }
+        FTSResultCache::instance().invalidate(indexDirectoryPath);
+    }
+
+}
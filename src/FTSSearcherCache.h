@@ -0,0 +1,216 @@
+#ifndef FTS_SEARCHER_CACHE_H
+#define FTS_SEARCHER_CACHE_H
+
+/**
+ *  Process-wide cache of full-text index searchers.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "FTSIndex.h"
+#include "FTSWriterCache.h"
+#include "LuceneHeaders.h"
+
+namespace LuceneUDR
+{
+
+    /// <summary>
+    /// Searcher over a point-in-time snapshot of a full-text index.
+    ///
+    /// The snapshot owns one reference of the index reader.
+    /// The reader is closed when the last holder of the snapshot releases it.
+    /// </summary>
+    class FTSSearcher final
+    {
+    public:
+        FTSSearcher() = delete;
+        FTSSearcher(Lucene::DirectoryPtr directory, Lucene::IndexReaderPtr reader);
+        FTSSearcher(Lucene::DirectoryPtr directory, Lucene::IndexReaderPtr reader, FTSMetadata::FTSKeyEncoding keyEncoding);
+
+        // non-copyable
+        FTSSearcher(const FTSSearcher& rhs) = delete;
+        FTSSearcher& operator=(const FTSSearcher& rhs) = delete;
+
+        ~FTSSearcher();
+
+        const Lucene::DirectoryPtr& directory() const
+        {
+            return m_directory;
+        }
+
+        const Lucene::IndexReaderPtr& reader() const
+        {
+            return m_reader;
+        }
+
+        const Lucene::IndexSearcherPtr& searcher() const
+        {
+            return m_searcher;
+        }
+
+        /// <summary>
+        /// Returns the segment readers of the snapshot in index order.
+        /// </summary>
+        const Lucene::Collection<Lucene::IndexReaderPtr>& segmentReaders() const
+        {
+            return m_segmentReaders;
+        }
+
+        /// <summary>
+        /// Returns the number of the first document of each segment.
+        /// </summary>
+        const std::vector<int32_t>& docStarts() const
+        {
+            return m_docStarts;
+        }
+
+        /// <summary>
+        /// Returns the key encoding of the index snapshot.
+        /// </summary>
+        FTSMetadata::FTSKeyEncoding keyEncoding() const
+        {
+            return m_keyEncoding;
+        }
+
+        /// <summary>
+        /// Returns the value of the key field of the document.
+        ///
+        /// Keys are taken from an in-memory column, which is loaded once per segment
+        /// and shared with the following snapshots while the segment is unchanged,
+        /// so the stored fields are not read.
+        /// </summary>
+        ///
+        /// <param name="keyFieldName">Key field name.</param>
+        /// <param name="doc">Document number.</param>
+        ///
+        /// <returns>Key value as it is indexed.</returns>
+        Lucene::String getKey(const Lucene::String& keyFieldName, int32_t doc);
+
+        /// <summary>
+        /// Returns the value of the integer key field of the document.
+        ///
+        /// With the binary key encoding the column holds decoded numbers,
+        /// so no terms are kept in memory and no conversion is done per hit.
+        /// </summary>
+        ///
+        /// <param name="keyFieldName">Key field name.</param>
+        /// <param name="doc">Document number.</param>
+        ///
+        /// <returns>Key value.</returns>
+        int64_t getIntKey(const Lucene::String& keyFieldName, int32_t doc);
+
+        /// <summary>
+        /// Loads the key column of the snapshot in advance, so the first search does not wait for it.
+        /// </summary>
+        ///
+        /// <param name="keyFieldName">Key field name.</param>
+        /// <param name="intKey">The key is an integer.</param>
+        void preloadKeys(const Lucene::String& keyFieldName, bool intKey);
+    private:
+        struct KeyColumn
+        {
+            Lucene::String fieldName;
+            bool numeric = false;
+            std::vector<Lucene::Collection<Lucene::String>> values;
+            std::vector<Lucene::Collection<int64_t>> numbers;
+        };
+        using KeyColumnPtr = std::shared_ptr<KeyColumn>;
+
+        KeyColumnPtr getKeyColumn(const Lucene::String& keyFieldName, bool numeric);
+
+        size_t findSegment(int32_t doc) const;
+
+        Lucene::DirectoryPtr m_directory;
+        Lucene::IndexReaderPtr m_reader;
+        Lucene::IndexSearcherPtr m_searcher;
+        Lucene::Collection<Lucene::IndexReaderPtr> m_segmentReaders;
+        std::vector<int32_t> m_docStarts;
+        FTSMetadata::FTSKeyEncoding m_keyEncoding;
+        std::mutex m_keyColumnMutex;
+        KeyColumnPtr m_keyColumn;
+    };
+
+    using FTSSearcherPtr = std::shared_ptr<FTSSearcher>;
+
+    /// <summary>
+    /// Process-wide cache of searchers keyed by the index directory.
+    ///
+    /// On each request the cached reader is checked against the last commit of the index.
+    /// If the index has changed, the reader is reopened, so only the changed segments are loaded.
+    /// If the index has a near-real-time writer, the reader is taken from the writer instead,
+    /// so the changes that are not yet committed are found as well.
+    /// The index with the RAM storage is searched in its in-memory copy,
+    /// which is copied from the disk again after each commit.
+    /// </summary>
+    class FTSSearcherCache final
+    {
+    public:
+        static FTSSearcherCache& instance();
+
+        // non-copyable
+        FTSSearcherCache(const FTSSearcherCache& rhs) = delete;
+        FTSSearcherCache& operator=(const FTSSearcherCache& rhs) = delete;
+
+        /// <summary>
+        /// Returns a searcher for the current commit of the index
+        /// or for the current state of its near-real-time writer.
+        /// </summary>
+        ///
+        /// <param name="indexDirectoryPath">Full path to the index directory.</param>
+        /// <param name="storage">Storage of the index.</param>
+        ///
+        /// <returns>Searcher or nullptr if the index does not exist in the directory.</returns>
+        FTSSearcherPtr acquire(const std::filesystem::path& indexDirectoryPath, FTSMetadata::FTSStorage storage);
+
+        /// <summary>
+        /// Removes the index searcher from the cache.
+        ///
+        /// Must be called before the index directory is deleted or recreated.
+        /// </summary>
+        ///
+        /// <param name="indexDirectoryPath">Full path to the index directory.</param>
+        void invalidate(const std::filesystem::path& indexDirectoryPath);
+
+    private:
+        FTSSearcherCache() = default;
+
+        struct Entry
+        {
+            std::mutex mutex;
+            FTSSearcherPtr searcher;
+            // near-real-time writer the snapshot was taken from and its generation
+            FTSWriterPtr writer;
+            uint64_t generation = 0;
+            FTSMetadata::FTSStorage storage = FTSMetadata::FTSStorage::FS;
+            // index on the disk the in-memory copy was made from and the version of its commit
+            Lucene::DirectoryPtr diskDirectory;
+            int64_t diskVersion = 0;
+        };
+        using EntryPtr = std::shared_ptr<Entry>;
+
+        // number of attempts to copy the last commit of the index, which may be replaced during the copy
+        static constexpr int MAX_COPY_ATTEMPTS = 5;
+
+        static void copyToRam(Entry& entry, const Lucene::DirectoryPtr& diskDirectory);
+
+        std::mutex m_mutex;
+        std::unordered_map<std::wstring, EntryPtr> m_entries;
+    };
+
+}
+
+#endif // FTS_SEARCHER_CACHE_H
@@ -13,32 +13,134 @@
 
 #include "FTSUtils.h"
 
+#include <chrono>
+#include <mutex>
 #include <string>
+#include <system_error>
+#include <unordered_map>
 
 #include "FBUtils.h"
 #include "inicpp.h"
 
 using namespace Firebird;
 
-namespace LuceneUDR
+namespace
 {
+    using namespace LuceneUDR;
+
+    // how often the settings files are checked for changes
+    constexpr std::chrono::seconds CONFIG_CHECK_INTERVAL{ 10 };
 
     /// <summary>
-    /// Returns the directory where full-text indexes are located.
+    /// Modification times of the settings files.
+    /// </summary>
+    struct ConfigStamp
+    {
+        fs::file_time_type confTime;
+        fs::file_time_type iniTime;
+
+        bool operator==(const ConfigStamp& other) const
+        {
+            return confTime == other.confTime && iniTime == other.iniTime;
+        }
+
+        static fs::file_time_type fileTime(const fs::path& filePath)
+        {
+            // a missing file gets the minimum time
+            std::error_code ec;
+            const auto fileTime = fs::last_write_time(filePath, ec);
+            return ec ? fs::file_time_type::min() : fileTime;
+        }
+
+        static ConfigStamp read(const fs::path& rootDirPath)
+        {
+            return { fileTime(rootDirPath / "fts.conf"), fileTime(rootDirPath / "fts.ini") };
+        }
+    };
+
+    /// <summary>
+    /// Process-wide cache of full-text index directories by database name.
+    /// </summary>
+    class FtsDirectoryCache final
+    {
+    public:
+        static FtsDirectoryCache& instance()
+        {
+            static FtsDirectoryCache cache;
+            return cache;
+        }
+
+        bool find(const std::string& databaseName, fs::path& ftsDirectoryPath)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = m_entries.find(databaseName);
+            if (it == m_entries.end()) {
+                return false;
+            }
+            auto& entry = it->second;
+            if (std::chrono::steady_clock::now() - entry.checkedAt < CONFIG_CHECK_INTERVAL) {
+                ftsDirectoryPath = entry.ftsDirectoryPath;
+                return true;
+            }
+            return false;
+        }
+
+        bool find(const std::string& databaseName, const ConfigStamp& stamp, fs::path& ftsDirectoryPath)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = m_entries.find(databaseName);
+            if (it == m_entries.end()) {
+                return false;
+            }
+            auto& entry = it->second;
+            if (entry.stamp == stamp) {
+                entry.checkedAt = std::chrono::steady_clock::now();
+                ftsDirectoryPath = entry.ftsDirectoryPath;
+                return true;
+            }
+            return false;
+        }
+
+        void put(const std::string& databaseName, const ConfigStamp& stamp, const fs::path& ftsDirectoryPath)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_entries[databaseName] = { ftsDirectoryPath, stamp, std::chrono::steady_clock::now() };
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_entries.clear();
+        }
+
+    private:
+        FtsDirectoryCache() = default;
+
+        struct Entry
+        {
+            fs::path ftsDirectoryPath;
+            ConfigStamp stamp;
+            std::chrono::steady_clock::time_point checkedAt;
+        };
+
+        std::mutex m_mutex;
+        std::unordered_map<std::string, Entry> m_entries;
+    };
+
+    /// <summary>
+    /// Reads the directory where full-text indexes are located from the settings files.
     /// </summary>
     /// 
     /// <param name="status">Status. </param>
     /// <param name="context">The context of the external routine.</param>
+    /// <param name="rootDirPath">Root directory of Firebird.</param>
     /// 
     /// <returns>Full path to full-text index directory</returns>
-    fs::path getFtsDirectory(ThrowStatusWrapper* status, IExternalContext* context) 
-    try {
+    fs::path readFtsDirectory(ThrowStatusWrapper* status, IExternalContext* context, const fs::path& rootDirPath)
+    {
         const auto pluginManager = context->getMaster()->getPluginManager();
-        IConfigManager* configManager = context->getMaster()->getConfigManager();
 
         const std::string databaseName(context->getDatabaseName());
-        const std::string rootDir(configManager->getRootDirectory());
-        const fs::path rootDirPath = rootDir;
 
         const fs::path confFilePath = rootDirPath / "fts.conf";
         if (fs::exists(confFilePath)) {
@@ -98,8 +200,55 @@ namespace LuceneUDR
             throw Firebird::FbException(status, statusVector);
         }
     }
+}
+
+namespace LuceneUDR
+{
+
+    /// <summary>
+    /// Returns the directory where full-text indexes are located.
+    /// 
+    /// The result is cached for each database. The settings files are checked
+    /// for changes no more often than once every CONFIG_CHECK_INTERVAL.
+    /// </summary>
+    /// 
+    /// <param name="status">Status. </param>
+    /// <param name="context">The context of the external routine.</param>
+    /// 
+    /// <returns>Full path to full-text index directory</returns>
+    fs::path getFtsDirectory(ThrowStatusWrapper* status, IExternalContext* context) 
+    try {
+        auto& cache = FtsDirectoryCache::instance();
+        const std::string databaseName(context->getDatabaseName());
+
+        fs::path ftsDirectoryPath;
+        if (cache.find(databaseName, ftsDirectoryPath)) {
+            return ftsDirectoryPath;
+        }
+
+        IConfigManager* configManager = context->getMaster()->getConfigManager();
+        const fs::path rootDirPath = std::string(configManager->getRootDirectory());
+
+        // the stamp is taken before reading, so that changes made during reading are not lost
+        const auto stamp = ConfigStamp::read(rootDirPath);
+        if (cache.find(databaseName, stamp, ftsDirectoryPath)) {
+            return ftsDirectoryPath;
+        }
+
+        ftsDirectoryPath = readFtsDirectory(status, context, rootDirPath);
+        cache.put(databaseName, stamp, ftsDirectoryPath);
+        return ftsDirectoryPath;
+    }
     catch (const std::exception& e) {
         IscRandomStatus statusVector(e);
         throw Firebird::FbException(status, statusVector);
     }
+
+    /// <summary>
+    /// Clears the cache of full-text index directories.
+    /// </summary>
+    void resetFtsDirectoryCache()
+    {
+        FtsDirectoryCache::instance().clear();
+    }
 }
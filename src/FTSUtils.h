@@ -32,6 +32,12 @@ namespace LuceneUDR
     /// <returns>Full path to full-text index directory</returns>
     fs::path getFtsDirectory(Firebird::ThrowStatusWrapper* status, Firebird::IExternalContext* context);
 
+    /// <summary>
+    /// Clears the cache of full-text index directories, 
+    /// so that the settings files are read again on the next call of getFtsDirectory.
+    /// </summary>
+    void resetFtsDirectoryCache();
+
     inline bool createIndexDirectory(const fs::path& indexDir)
     {
         if (!fs::is_directory(indexDir)) {
@@ -0,0 +1,124 @@
+/**
+ *  Process-wide registry of near-real-time index writers.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "FTSWriterCache.h"
+
+#include "FTSHelper.h"
+
+using namespace Lucene;
+
+namespace LuceneUDR
+{
+
+    FTSWriter::FTSWriter(IndexWriterPtr writer, FTSMetadata::FTSKeyEncoding keyEncoding)
+        : m_writer(std::move(writer))
+        , m_keyEncoding(keyEncoding)
+    {
+    }
+
+    void FTSWriter::publish()
+    {
+        ++m_generation;
+    }
+
+    void FTSWriter::commit(const FTSLogRanges& logIds)
+    {
+        std::lock_guard<std::mutex> lock(m_commitMutex);
+        m_writer->commit(makeCommitUserData(m_keyEncoding, logIds));
+    }
+
+    FTSWriterCache& FTSWriterCache::instance()
+    {
+        static FTSWriterCache cache;
+        return cache;
+    }
+
+    FTSWriterCache::~FTSWriterCache()
+    {
+        // the changes not yet committed are saved when the library is unloaded
+        for (auto& [key, writer] : m_writers) {
+            try {
+                writer->commit();
+                writer->writer()->close();
+            }
+            catch (...) {
+                // the process is terminating, the entries not committed stay in FTS$LOG and are applied again
+            }
+        }
+    }
+
+    FTSWriterPtr FTSWriterCache::find(const std::filesystem::path& indexDirectoryPath)
+    {
+        const auto key = indexDirectoryPath.wstring();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_writers.find(key);
+        if (it == m_writers.end()) {
+            return nullptr;
+        }
+        return it->second;
+    }
+
+    FTSWriterPtr FTSWriterCache::put(
+        const std::filesystem::path& indexDirectoryPath,
+        const IndexWriterPtr& writer,
+        FTSMetadata::FTSKeyEncoding keyEncoding
+    )
+    {
+        const auto key = indexDirectoryPath.wstring();
+        auto ftsWriter = std::make_shared<FTSWriter>(writer, keyEncoding);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_writers[key] = ftsWriter;
+        return ftsWriter;
+    }
+
+    void FTSWriterCache::remove(const std::filesystem::path& indexDirectoryPath)
+    {
+        const auto key = indexDirectoryPath.wstring();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_writers.erase(key);
+    }
+
+    void FTSWriterCache::close(const std::filesystem::path& indexDirectoryPath)
+    {
+        const auto key = indexDirectoryPath.wstring();
+
+        FTSWriterPtr writer;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = m_writers.find(key);
+            if (it == m_writers.end()) {
+                return;
+            }
+            writer = it->second;
+            m_writers.erase(it);
+        }
+        writer->commit();
+        writer->writer()->close();
+    }
+
+    FTSLogState& FTSWriterCache::logState(const std::filesystem::path& ftsDirectoryPath)
+    {
+        const auto key = ftsDirectoryPath.wstring();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& state = m_logStates[key];
+        if (!state) {
+            state = std::make_unique<FTSLogState>();
+        }
+        return *state;
+    }
+
+}
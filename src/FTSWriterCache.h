@@ -0,0 +1,183 @@
+#ifndef FTS_WRITER_CACHE_H
+#define FTS_WRITER_CACHE_H
+
+/**
+ *  Process-wide registry of near-real-time index writers.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "FTSIndex.h"
+#include "FTSLogRanges.h"
+#include "LuceneHeaders.h"
+
+namespace LuceneUDR
+{
+
+    /// <summary>
+    /// Long-lived writer of a full-text index in the near-real-time mode.
+    ///
+    /// The writer stays open between the runs of FTS$UPDATE_INDEXES.
+    /// Searchers take their readers from the writer, so a change is searchable without a commit.
+    /// The writer is committed by FTS$UPDATE_INDEXES once per FTSLogState::COMMIT_INTERVAL.
+    /// </summary>
+    class FTSWriter final
+    {
+    public:
+        FTSWriter() = delete;
+        FTSWriter(Lucene::IndexWriterPtr writer, FTSMetadata::FTSKeyEncoding keyEncoding);
+
+        // non-copyable
+        FTSWriter(const FTSWriter& rhs) = delete;
+        FTSWriter& operator=(const FTSWriter& rhs) = delete;
+
+        const Lucene::IndexWriterPtr& writer() const
+        {
+            return m_writer;
+        }
+
+        FTSMetadata::FTSKeyEncoding keyEncoding() const
+        {
+            return m_keyEncoding;
+        }
+
+        /// <summary>
+        /// Returns the number of the published changes of the writer.
+        ///
+        /// Searchers compare it with the generation of their snapshot to find out that the snapshot is stale.
+        /// </summary>
+        uint64_t generation() const
+        {
+            return m_generation.load();
+        }
+
+        /// <summary>
+        /// Makes the changes of the writer visible to the following searches without a commit.
+        /// </summary>
+        void publish();
+
+        /// <summary>
+        /// Commits the changes of the writer.
+        /// </summary>
+        ///
+        /// <param name="logIds">FTS$LOG entries whose changes are contained in the commit.</param>
+        void commit(const FTSLogRanges& logIds = FTSLogRanges());
+
+    private:
+        Lucene::IndexWriterPtr m_writer;
+        FTSMetadata::FTSKeyEncoding m_keyEncoding;
+        std::atomic<uint64_t> m_generation{ 0 };
+        std::mutex m_commitMutex;
+    };
+
+    using FTSWriterPtr = std::shared_ptr<FTSWriter>;
+
+    /// <summary>
+    /// FTS$LOG entries of a database applied by the near-real-time writers.
+    ///
+    /// The entries applied but not committed yet stay in FTS$LOG, so they are applied again
+    /// if the process terminates. The following runs skip them, and they are deleted after the commit.
+    /// </summary>
+    struct FTSLogState
+    {
+        // the near-real-time writers are committed not more often than this
+        static constexpr std::chrono::seconds COMMIT_INTERVAL{ 60 };
+
+        // serializes the runs of FTS$UPDATE_INDEXES of the database
+        std::mutex mutex;
+        // entries applied by the writers since their last commit
+        FTSLogRanges applied;
+        std::chrono::steady_clock::time_point lastCommit;
+    };
+
+    /// <summary>
+    /// Process-wide registry of near-real-time writers keyed by the index directory.
+    ///
+    /// An index has at most one writer, it holds the write lock of the index directory while it is registered.
+    /// The writer must be closed before the index is rebuilt, optimized or deleted.
+    /// </summary>
+    class FTSWriterCache final
+    {
+    public:
+        static FTSWriterCache& instance();
+
+        // non-copyable
+        FTSWriterCache(const FTSWriterCache& rhs) = delete;
+        FTSWriterCache& operator=(const FTSWriterCache& rhs) = delete;
+
+        ~FTSWriterCache();
+
+        /// <summary>
+        /// Returns the writer of the index.
+        /// </summary>
+        ///
+        /// <param name="indexDirectoryPath">Full path to the index directory.</param>
+        ///
+        /// <returns>Writer or nullptr if the index is not in the near-real-time mode.</returns>
+        FTSWriterPtr find(const std::filesystem::path& indexDirectoryPath);
+
+        /// <summary>
+        /// Registers the writer of the index.
+        /// </summary>
+        ///
+        /// <param name="indexDirectoryPath">Full path to the index directory.</param>
+        /// <param name="writer">Opened index writer.</param>
+        /// <param name="keyEncoding">Key encoding of the index.</param>
+        ///
+        /// <returns>Registered writer.</returns>
+        FTSWriterPtr put(
+            const std::filesystem::path& indexDirectoryPath,
+            const Lucene::IndexWriterPtr& writer,
+            FTSMetadata::FTSKeyEncoding keyEncoding
+        );
+
+        /// <summary>
+        /// Removes the writer of the index from the registry without closing it.
+        /// </summary>
+        ///
+        /// <param name="indexDirectoryPath">Full path to the index directory.</param>
+        void remove(const std::filesystem::path& indexDirectoryPath);
+
+        /// <summary>
+        /// Commits and closes the writer of the index, if any.
+        ///
+        /// Must be called before the index directory is opened by another writer, deleted or recreated.
+        /// </summary>
+        ///
+        /// <param name="indexDirectoryPath">Full path to the index directory.</param>
+        void close(const std::filesystem::path& indexDirectoryPath);
+
+        /// <summary>
+        /// Returns the FTS$LOG state of the database.
+        /// </summary>
+        ///
+        /// <param name="ftsDirectoryPath">Full path to the directory of the indexes of the database.</param>
+        FTSLogState& logState(const std::filesystem::path& ftsDirectoryPath);
+
+    private:
+        FTSWriterCache() = default;
+
+        std::mutex m_mutex;
+        std::unordered_map<std::wstring, FTSWriterPtr> m_writers;
+        std::unordered_map<std::wstring, std::unique_ptr<FTSLogState>> m_logStates;
+    };
+
+}
+
+#endif // FTS_WRITER_CACHE_H
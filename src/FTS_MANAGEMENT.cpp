@@ -19,6 +19,8 @@
 #include "FBUtils.h"
 #include "FTSHelper.h"
 #include "FTSIndex.h"
+#include "FTSSearcherCache.h"
+#include "FTSWriterCache.h"
 #include "FTSUtils.h"
 #include "LuceneAnalyzerFactory.h"
 #include "LuceneUdr.h"
@@ -63,6 +65,25 @@ FB_UDR_BEGIN_FUNCTION(getFTSDirectory)
     }
 FB_UDR_END_FUNCTION
 
+/***
+PROCEDURE FTS$RELOAD_CONFIG
+EXTERNAL NAME 'luceneudr!reloadConfig'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(reloadConfig)
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        resetFtsDirectoryCache();
+    }
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        return false;
+    }
+
+FB_UDR_END_PROCEDURE
+
 /***
 PROCEDURE FTS$SYSTEM_ANALYZERS
 RETURNS (
@@ -80,11 +101,11 @@ FB_UDR_BEGIN_PROCEDURE(systemAnalyzers)
     );
 
     FB_UDR_CONSTRUCTOR
-        , analyzers(std::make_unique<LuceneAnalyzerFactory>())
+        , analyzers(LuceneAnalyzerFactory::instance())
     {
     }
 
-    std::unique_ptr<LuceneAnalyzerFactory> analyzers;
+    const LuceneAnalyzerFactory& analyzers;
 
     void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
         char* name, unsigned nameSize)
@@ -96,7 +117,7 @@ FB_UDR_BEGIN_PROCEDURE(systemAnalyzers)
 
     FB_UDR_EXECUTE_PROCEDURE
     {
-        analyzerInfos = procedure->analyzers->getAnalyzerInfos();
+        analyzerInfos = procedure->analyzers.getAnalyzerInfos();
         it = analyzerInfos.begin();
     }
 
@@ -145,11 +166,11 @@ FB_UDR_BEGIN_PROCEDURE(getSystemAnalyzer)
     );
 
     FB_UDR_CONSTRUCTOR
-        , analyzers(std::make_unique<LuceneAnalyzerFactory>())
+        , analyzers(LuceneAnalyzerFactory::instance())
     {
     }
 
-    std::unique_ptr<LuceneAnalyzerFactory> analyzers;
+    const LuceneAnalyzerFactory& analyzers;
 
     void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
         char* name, unsigned nameSize)
@@ -164,7 +185,7 @@ FB_UDR_BEGIN_PROCEDURE(getSystemAnalyzer)
         if (!in->analyzerNameNull) {
             std::string_view analyzerName(in->analyzerName.str, in->analyzerName.length);
 
-            auto info = procedure->analyzers->getAnalyzerInfo(status, analyzerName);
+            auto info = procedure->analyzers.getAnalyzerInfo(status, analyzerName);
 
             fetchFlag = true;
 
@@ -213,11 +234,11 @@ FB_UDR_BEGIN_FUNCTION(hasSystemAnalyzer)
     );
 
     FB_UDR_CONSTRUCTOR
-        , analyzers(std::make_unique<LuceneAnalyzerFactory>())
+        , analyzers(LuceneAnalyzerFactory::instance())
     {
     }
 
-    std::unique_ptr<LuceneAnalyzerFactory> analyzers;
+    const LuceneAnalyzerFactory& analyzers;
 
     void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
         char* name, unsigned nameSize)
@@ -232,7 +253,7 @@ FB_UDR_BEGIN_FUNCTION(hasSystemAnalyzer)
         out->existsNull = false;
         if (!in->analyzerNull) {
             std::string_view analyzerName(in->analyzer.str, in->analyzer.length);
-            out->exists = analyzers->hasAnalyzer(analyzerName);
+            out->exists = analyzers.hasAnalyzer(analyzerName);
         } 
         else {
             out->exists = false;
@@ -483,6 +504,15 @@ FB_UDR_BEGIN_PROCEDURE(dropIndex)
 
         const auto ftsDirectoryPath = getFtsDirectory(status, context);
         const auto indexDirectoryPath = ftsDirectoryPath / indexName;
+        // release the near-real-time writer and the cached searcher so that the index files are not held open
+        try {
+            FTSWriterCache::instance().close(indexDirectoryPath);
+        }
+        catch (const LuceneException& e) {
+            const std::string error_message = StringUtils::toUTF8(e.getError());
+            throwException(status, error_message.c_str());
+        }
+        FTSSearcherCache::instance().invalidate(indexDirectoryPath);
         // If the directory exists, then delete it.
         if (!removeIndexDirectory(indexDirectoryPath)) {
             throwException(status, R"(Cannot delete index directory "%s".)", indexDirectoryPath.u8string().c_str());
@@ -720,6 +750,58 @@ FB_UDR_BEGIN_PROCEDURE(setIndexFieldBoost)
 FB_UDR_END_PROCEDURE
 
 
+/***
+PROCEDURE FTS$SET_INDEX_FIELD_SORTABLE (
+     FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+     FTS$FIELD_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL,
+     FTS$SORTABLE BOOLEAN NOT NULL
+)
+EXTERNAL NAME 'luceneudr!setIndexFieldSortable'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(setIndexFieldSortable)
+    FB_UDR_MESSAGE(InMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), indexName)
+        (FB_INTL_VARCHAR(252, CS_UTF8), fieldName)
+        (FB_BOOLEAN, sortable)
+    );
+
+    FB_UDR_CONSTRUCTOR
+        , indexRepository(std::make_unique<FTSIndexRepository>(context->getMaster()))
+    {
+    }
+
+    FTSIndexRepositoryPtr indexRepository;
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        std::string_view indexName(in->indexName.str, in->indexName.length);
+        std::string_view fieldName(in->fieldName.str, in->fieldName.length);
+
+        AutoRelease<IAttachment> att(context->getAttachment(status));
+        AutoRelease<ITransaction> tra(context->getTransaction(status));
+
+        const unsigned int sqlDialect = getSqlDialect(status, att);
+
+        procedure->indexRepository->setIndexFieldSortable(status, att, tra, sqlDialect, indexName, fieldName, in->sortable);
+    }
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        return false;
+    }
+
+FB_UDR_END_PROCEDURE
+
+
 /***
 PROCEDURE FTS$REBUILD_INDEX (
     FTS$INDEX_NAME VARCHAR(63) CHARACTER SET UTF8 NOT NULL
@@ -765,6 +847,8 @@ FB_UDR_BEGIN_PROCEDURE(rebuildIndex)
         try {
             // get FTS index metadata
             auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName, true);
+            // the index is rebuilt by its own writer, the near-real-time writer releases the write lock
+            FTSWriterCache::instance().close(ftsDirectoryPath / indexName);
             // prepare index to rebuild
             auto preparedIndex = prepareFtsIndex(
                 status, context->getMaster(), att, tra, sqlDialect, 
@@ -775,10 +859,12 @@ FB_UDR_BEGIN_PROCEDURE(rebuildIndex)
 
             preparedIndex.rebuild(status, att, tra);
 
-            preparedIndex.optimize(status); 
             preparedIndex.commit(status);
             preparedIndex.close(status);
 
+            // the index has been recreated, searchers over the old segments are no longer needed
+            FTSSearcherCache::instance().invalidate(ftsDirectoryPath / indexName);
+
             // if the index building was successful, then set the indexing completion status
             procedure->indexRepository->setIndexStatus(status, att, tra, sqlDialect, indexName, "C");
         }
@@ -848,7 +934,10 @@ FB_UDR_BEGIN_PROCEDURE(optimizeIndex)
                 throwException(status, R"(Index directory "%s" not exists.)", indexDirectoryPath.u8string().c_str());
             }
 
-            auto fsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
+            // the near-real-time writer releases the write lock
+            FTSWriterCache::instance().close(indexDirectoryPath);
+
+            auto fsIndexDir = openIndexDirectory(indexDirectoryPath, ftsIndex.storage);
             auto analyzer = procedure->analyzerRepository->createAnalyzer(status, att, tra, sqlDialect, ftsIndex.analyzer);
             auto writer = newLucene<IndexWriter>(fsIndexDir, analyzer, false, IndexWriter::MaxFieldLengthUNLIMITED);
 
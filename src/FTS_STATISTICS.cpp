@@ -13,6 +13,9 @@
 
 #include <algorithm>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "LuceneUdr.h"
 #include "LuceneHeaders.h"
@@ -24,6 +27,10 @@
 #include "FieldInfos.h"
 #include "FileUtils.h"
 #include "FTSIndex.h"
+#include "FTSFilterCache.h"
+#include "FTSHelper.h"
+#include "FTSQueryCache.h"
+#include "FTSResultCache.h"
 #include "FTSUtils.h"
 #include "IndexFileNameFilter.h"
 #include "IndexFileNames.h"
@@ -167,7 +174,7 @@ FB_UDR_BEGIN_PROCEDURE(getIndexStatistics)
                 out->indexExists = false;
             }
             else {
-                const auto& ftsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
+                const auto& ftsIndexDir = openIndexDirectory(indexDirectoryPath, ftsIndex.storage);
                 if (!IndexReader::indexExists(ftsIndexDir)) {
                     // index created, but not build
                     ftsIndex.status = "N";
@@ -285,9 +292,7 @@ FB_UDR_BEGIN_PROCEDURE(getIndexFields)
 
         try {
             // check for index existence
-            if (!procedure->indexRepository->hasIndex(status, att, tra, sqlDialect, indexName)) {
-                throwException(status, R"(Index "%s" not exists)", indexName.c_str());
-            }
+            const auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName);
 
 
             const auto indexDirectoryPath = ftsDirectoryPath / indexName;
@@ -297,7 +302,7 @@ FB_UDR_BEGIN_PROCEDURE(getIndexFields)
                 throwException(status, R"(Index directory "%s" not exists.)", indexDirectoryPath.u8string().c_str());
             }
 
-            const auto ftsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
+            const auto ftsIndexDir = openIndexDirectory(indexDirectoryPath, ftsIndex.storage);
             if (!IndexReader::indexExists(ftsIndexDir)) {
                 throwException(status, R"(Index "%s" not build.)", indexName.c_str());
             }
@@ -401,9 +406,7 @@ FB_UDR_BEGIN_PROCEDURE(getIndexFiles)
 
         try {
             // check for index existence
-            if (!procedure->indexRepository->hasIndex(status, att, tra, sqlDialect, indexName)) {
-                throwException(status, R"(Index "%s" not exists)", indexName.c_str());
-            }
+            const auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName);
 
 
             const auto indexDirectoryPath = ftsDirectoryPath / indexName;
@@ -414,7 +417,7 @@ FB_UDR_BEGIN_PROCEDURE(getIndexFiles)
             }
 
             const auto unicodeIndexDir = indexDirectoryPath.wstring();
-            const auto ftsIndexDir = FSDirectory::open(unicodeIndexDir);
+            const auto ftsIndexDir = openIndexDirectory(indexDirectoryPath, ftsIndex.storage);
             luceneFileHelper.setDirectory(ftsIndexDir);
 
             auto allFileNames = ftsIndexDir->listAll();
@@ -537,9 +540,7 @@ FB_UDR_BEGIN_PROCEDURE(getIndexSegments)
 
         try {
             // check for index existence
-            if (!procedure->indexRepository->hasIndex(status, att, tra, sqlDialect, indexName)) {
-                throwException(status, R"(Index "%s" not exists)", indexName.c_str());
-            }
+            const auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName);
 
             const auto indexDirectoryPath = ftsDirectoryPath / indexName;
 
@@ -548,7 +549,7 @@ FB_UDR_BEGIN_PROCEDURE(getIndexSegments)
                 throwException(status, R"(Index directory "%s" not exists.)", indexDirectoryPath.u8string().c_str());
             }
             
-            auto ftsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
+            auto ftsIndexDir = openIndexDirectory(indexDirectoryPath, ftsIndex.storage);
             segmentInfos = newLucene<SegmentInfos>();
             segmentInfos->read(ftsIndexDir);
             
@@ -689,9 +690,7 @@ FB_UDR_BEGIN_PROCEDURE(getFieldInfos)
 
         try {
             // check for index existence
-            if (!procedure->indexRepository->hasIndex(status, att, tra, sqlDialect, indexName)) {
-                throwException(status, R"(Index "%s" not exists)", indexName.c_str());
-            }
+            const auto ftsIndex = procedure->indexRepository->getIndex(status, att, tra, sqlDialect, indexName);
 
             const auto indexDirectoryPath = ftsDirectoryPath / indexName;
 
@@ -700,7 +699,7 @@ FB_UDR_BEGIN_PROCEDURE(getFieldInfos)
                 throwException(status, R"(Index directory "%s" not exists.)", indexDirectoryPath.u8string().c_str());
             }
 
-            auto ftsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
+            auto ftsIndexDir = openIndexDirectory(indexDirectoryPath, ftsIndex.storage);
             auto segmentInfos = newLucene<SegmentInfos>();
             segmentInfos->read(ftsIndexDir);
         
@@ -847,7 +846,7 @@ FB_UDR_BEGIN_PROCEDURE(indexTerms)
                 throwException(status, R"(Index directory "%s" not exists.)", indexDirectoryPath.u8string().c_str());
             }
 
-            auto ftsIndexDir = FSDirectory::open(indexDirectoryPath.wstring());
+            auto ftsIndexDir = openIndexDirectory(indexDirectoryPath, ftsIndex.storage);
             auto reader = IndexReader::open(ftsIndexDir, true);
             termIt = reader->terms();
             out->field_nameNull = true;
@@ -893,3 +892,71 @@ FB_UDR_BEGIN_PROCEDURE(indexTerms)
     }
 
 FB_UDR_END_PROCEDURE
+
+/***
+PROCEDURE FTS$CACHE_STATISTICS
+RETURNS (
+  FTS$CACHE_NAME VARCHAR(63) CHARACTER SET UTF8,
+  FTS$CAPACITY INTEGER,
+  FTS$SIZE INTEGER,
+  FTS$HITS BIGINT,
+  FTS$MISSES BIGINT
+)
+EXTERNAL NAME 'luceneudr!getCacheStatistics'
+ENGINE UDR;
+***/
+FB_UDR_BEGIN_PROCEDURE(getCacheStatistics)
+    FB_UDR_MESSAGE(OutMessage,
+        (FB_INTL_VARCHAR(252, CS_UTF8), cacheName)
+        (FB_INTEGER, capacity)
+        (FB_INTEGER, size)
+        (FB_BIGINT, hits)
+        (FB_BIGINT, misses)
+    );
+
+    void getCharSet([[maybe_unused]] ThrowStatusWrapper* status, [[maybe_unused]] IExternalContext* context,
+        char* name, unsigned nameSize)
+    {
+        // Forced internal request encoding to UTF8
+        memset(name, 0, nameSize);
+        memcpy(name, INTERNAL_UDR_CHARSET, std::size(INTERNAL_UDR_CHARSET));
+    }
+
+    FB_UDR_EXECUTE_PROCEDURE
+    {
+        caches.emplace_back("QUERY", FTSQueryCache::instance().statistics());
+        caches.emplace_back("FILTER", FTSFilterCache::instance().statistics());
+        caches.emplace_back("RESULT", FTSResultCache::instance().statistics());
+        it = caches.cbegin();
+    }
+
+    std::vector<std::pair<std::string, FTSCacheStatistics>> caches;
+    std::vector<std::pair<std::string, FTSCacheStatistics>>::const_iterator it;
+
+    FB_UDR_FETCH_PROCEDURE
+    {
+        if (it == caches.cend()) {
+            return false;
+        }
+        const auto& [cacheName, statistics] = *it;
+
+        out->cacheNameNull = false;
+        out->cacheName.length = static_cast<ISC_USHORT>(cacheName.length());
+        cacheName.copy(out->cacheName.str, out->cacheName.length);
+
+        out->capacityNull = false;
+        out->capacity = static_cast<ISC_LONG>(statistics.capacity);
+
+        out->sizeNull = false;
+        out->size = static_cast<ISC_LONG>(statistics.size);
+
+        out->hitsNull = false;
+        out->hits = static_cast<ISC_INT64>(statistics.hits);
+
+        out->missesNull = false;
+        out->misses = static_cast<ISC_INT64>(statistics.misses);
+
+        ++it;
+        return true;
+    }
+FB_UDR_END_PROCEDURE
@@ -0,0 +1,46 @@
+/**
+ *  Collector that only counts hits.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "HitCountCollector.h"
+
+namespace Lucene
+{
+
+    HitCountCollector::HitCountCollector()
+        : totalHits(0)
+    {
+    }
+
+    HitCountCollector::~HitCountCollector() {
+    }
+
+    void HitCountCollector::setScorer(const ScorerPtr& scorer) {
+        // scores are not needed
+    }
+
+    void HitCountCollector::collect(int32_t doc) {
+        ++totalHits;
+    }
+
+    void HitCountCollector::setNextReader(const IndexReaderPtr& reader, int32_t docBase) {
+    }
+
+    bool HitCountCollector::acceptsDocsOutOfOrder() {
+        return true;
+    }
+
+    int32_t HitCountCollector::getTotalHits() {
+        return totalHits;
+    }
+
+}
@@ -0,0 +1,50 @@
+#ifndef LUCENE_HIT_COUNT_COLLECTOR_H
+#define LUCENE_HIT_COUNT_COLLECTOR_H
+
+/**
+ *  Collector that only counts hits.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "LuceneHeaders.h"
+#include "Collector.h"
+
+namespace Lucene
+{
+    /// Counts the hits of a query.
+    ///
+    /// Scores are never requested and no hits are kept, so the count costs
+    /// only the matching of the documents. Documents are accepted in any order.
+    class HitCountCollector : public Collector {
+    public:
+        HitCountCollector();
+
+        virtual ~HitCountCollector();
+
+        LUCENE_CLASS(HitCountCollector);
+
+    public:
+        virtual void setScorer(const ScorerPtr& scorer);
+        virtual void collect(int32_t doc);
+        virtual void setNextReader(const IndexReaderPtr& reader, int32_t docBase);
+        virtual bool acceptsDocsOutOfOrder();
+
+        /// Returns the number of collected hits.
+        int32_t getTotalHits();
+
+    protected:
+        int32_t totalHits;
+    };
+
+    typedef boost::shared_ptr<HitCountCollector> HitCountCollectorPtr;
+}
+
+#endif // LUCENE_HIT_COUNT_COLLECTOR_H
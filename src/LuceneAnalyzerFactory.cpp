@@ -11,6 +11,8 @@
  *  Contributor(s): ______________________________________.
 **/
 
+#include <algorithm>
+#include <cctype>
 #include <functional>
 #include <stdexcept>
 
@@ -338,86 +340,101 @@ namespace LuceneUDR
                 }
             }
         }
+        , m_analyzerNames()
     {
-
+        m_analyzerNames.reserve(m_factories.size());
+        for (const auto& pFactory : m_factories) {
+            m_analyzerNames.push_back(pFactory.first);
+        }
+        std::sort(m_analyzerNames.begin(), m_analyzerNames.end());
     }
 
     LuceneAnalyzerFactory::~LuceneAnalyzerFactory() = default;
 
+    const LuceneAnalyzerFactory& LuceneAnalyzerFactory::instance()
+    {
+        static const LuceneAnalyzerFactory factory;
+        return factory;
+    }
+
+    const LuceneAnalyzerFactory::AnalyzerFactory* LuceneAnalyzerFactory::findFactory(std::string_view analyzerName) const
+    {
+        std::string key(analyzerName);
+        std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+        const auto pFactory = m_factories.find(key);
+        if (pFactory == m_factories.end()) {
+            return nullptr;
+        }
+        return &pFactory->second;
+    }
+
     bool LuceneAnalyzerFactory::hasAnalyzer(std::string_view analyzerName) const
     {
-        return (m_factories.find(analyzerName) != m_factories.end());
+        return (findFactory(analyzerName) != nullptr);
     }
 
     bool LuceneAnalyzerFactory::isStopWordsSupported(std::string_view analyzerName) const
     {
-        auto pFactory = m_factories.find(analyzerName);
-        if (pFactory == m_factories.end()) {
+        const auto factory = findFactory(analyzerName);
+        if (!factory) {
             return false;
         }
-        auto factory = pFactory->second;
-        return factory.stopWordsSupported;
+        return factory->stopWordsSupported;
     }
 
     AnalyzerPtr LuceneAnalyzerFactory::createAnalyzer(ThrowStatusWrapper* status, std::string_view analyzerName) const
     {
-        auto pFactory = m_factories.find(analyzerName);
-        if (pFactory == m_factories.end()) {
+        const auto factory = findFactory(analyzerName);
+        if (!factory) {
             std::string sAnalyzerName{ analyzerName };
             throwException(status, R"(Analyzer "%s" not found.)", sAnalyzerName.c_str());
         }
-        auto factory = pFactory->second;
-        return factory.simpleFactory();
+        return factory->simpleFactory();
     }
 
     AnalyzerPtr LuceneAnalyzerFactory::createAnalyzer(ThrowStatusWrapper* status, std::string_view analyzerName, const HashSet<String> stopWords) const
     {
-        auto pFactory = m_factories.find(analyzerName);
-        if (pFactory == m_factories.end()) {
+        const auto factory = findFactory(analyzerName);
+        if (!factory) {
             std::string sAnalyzerName{ analyzerName };
             throwException(status, R"(Analyzer "%s" not found.)", sAnalyzerName.c_str());
         }
-        auto factory = pFactory->second;
-        return factory.extFactory(stopWords);
+        return factory->extFactory(stopWords);
     }
 
     std::unordered_set<std::string> LuceneAnalyzerFactory::getAnalyzerNames() const
     {
-        std::unordered_set<std::string> names;
-        for (auto&& pFactory : m_factories) {
-            names.insert(pFactory.first);
-        }
-        return names;
+        return { m_analyzerNames.begin(), m_analyzerNames.end() };
     }
 
     AnalyzerInfo LuceneAnalyzerFactory::getAnalyzerInfo(ThrowStatusWrapper* status, std::string_view analyzerName) const
     {
-        auto pFactory = m_factories.find(analyzerName);
-        if (pFactory == m_factories.end()) {
+        const auto factory = findFactory(analyzerName);
+        if (!factory) {
             std::string sAnalyzerName{ analyzerName };
             throwException(status, R"(Analyzer "%s" not found.)", sAnalyzerName.c_str());
         }
-        auto factory = pFactory->second;
-        return { analyzerName, "", factory.stopWordsSupported, true };
+        return { analyzerName, "", factory->stopWordsSupported, true };
     }
 
     std::list<AnalyzerInfo> LuceneAnalyzerFactory::getAnalyzerInfos() const
     {
         std::list<AnalyzerInfo> infos;
-        for (const auto& pFactory : m_factories) {
-            infos.emplace_back(pFactory.first, "", pFactory.second.stopWordsSupported, true);
+        for (const auto& analyzerName : m_analyzerNames) {
+            const auto& factory = m_factories.at(analyzerName);
+            infos.emplace_back(analyzerName, "", factory.stopWordsSupported, true);
         }
         return infos;
     }
 
     HashSet<String> LuceneAnalyzerFactory::getAnalyzerStopWords(ThrowStatusWrapper* status, std::string_view analyzerName) const
     {
-        auto pFactory = m_factories.find(analyzerName);
-        if (pFactory == m_factories.end()) {
+        const auto factory = findFactory(analyzerName);
+        if (!factory) {
             std::string sAnalyzerName{ analyzerName };
             throwException(status, R"(Analyzer "%s" not found.)", sAnalyzerName.c_str());
         }
-        auto factory = pFactory->second;
-        return factory.getStopWords();
+        return factory->getStopWords();
     }
 }
@@ -15,10 +15,11 @@
 **/
 
 #include <list>
-#include <map>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "LuceneHeaders.h"
 #include "LuceneUdr.h"
@@ -65,6 +66,12 @@ namespace LuceneUDR
         bool systemFlag;
     };
 
+    /// <summary>
+    /// Registry of system analyzers.
+    ///
+    /// The registry is immutable and shared by the whole process.
+    /// Analyzer names are case-insensitive.
+    /// </summary>
     class LuceneAnalyzerFactory final {
     private:
         struct AnalyzerFactory
@@ -75,11 +82,21 @@ namespace LuceneUDR
             bool stopWordsSupported;
         };
 
-        std::map<std::string, AnalyzerFactory, ci_less> m_factories;
+        // key - analyzer name in upper case
+        std::unordered_map<std::string, AnalyzerFactory> m_factories;
+        // analyzer names in alphabetical order
+        std::vector<std::string> m_analyzerNames;
+
+        LuceneAnalyzerFactory();
+
+        const AnalyzerFactory* findFactory(std::string_view analyzerName) const;
 
     public:
+        static const LuceneAnalyzerFactory& instance();
 
-        LuceneAnalyzerFactory();
+        // non-copyable
+        LuceneAnalyzerFactory(const LuceneAnalyzerFactory& rhs) = delete;
+        LuceneAnalyzerFactory& operator=(const LuceneAnalyzerFactory& rhs) = delete;
 
         ~LuceneAnalyzerFactory();
 
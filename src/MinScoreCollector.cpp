@@ -0,0 +1,50 @@
+/**
+ *  Collector that drops hits below a minimum score.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "MinScoreCollector.h"
+
+#include "ScoreCachingWrappingScorer.h"
+
+namespace Lucene
+{
+
+    MinScoreCollector::MinScoreCollector(const CollectorPtr& collector, double minScore)
+        : collector(collector)
+        , minScore(minScore)
+    {
+    }
+
+    MinScoreCollector::~MinScoreCollector() {
+    }
+
+    void MinScoreCollector::setScorer(const ScorerPtr& scorer) {
+        // the wrapped collector gets the score calculated by this collector
+        this->scorer = newLucene<ScoreCachingWrappingScorer>(scorer);
+        collector->setScorer(this->scorer);
+    }
+
+    void MinScoreCollector::collect(int32_t doc) {
+        if (scorer->score() >= minScore) {
+            collector->collect(doc);
+        }
+    }
+
+    void MinScoreCollector::setNextReader(const IndexReaderPtr& reader, int32_t docBase) {
+        collector->setNextReader(reader, docBase);
+    }
+
+    bool MinScoreCollector::acceptsDocsOutOfOrder() {
+        return collector->acceptsDocsOutOfOrder();
+    }
+
+}
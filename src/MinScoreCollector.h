@@ -0,0 +1,49 @@
+#ifndef LUCENE_MIN_SCORE_COLLECTOR_H
+#define LUCENE_MIN_SCORE_COLLECTOR_H
+
+/**
+ *  Collector that drops hits below a minimum score.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "LuceneHeaders.h"
+#include "Collector.h"
+
+namespace Lucene
+{
+    /// Passes to the wrapped collector only the hits with a score not less than the minimum.
+    ///
+    /// The score of a hit is calculated once and cached for the wrapped collector,
+    /// so low-scoring hits never enter its priority queue.
+    class MinScoreCollector : public Collector {
+    public:
+        MinScoreCollector(const CollectorPtr& collector, double minScore);
+
+        virtual ~MinScoreCollector();
+
+        LUCENE_CLASS(MinScoreCollector);
+
+    public:
+        virtual void setScorer(const ScorerPtr& scorer);
+        virtual void collect(int32_t doc);
+        virtual void setNextReader(const IndexReaderPtr& reader, int32_t docBase);
+        virtual bool acceptsDocsOutOfOrder();
+
+    protected:
+        CollectorPtr collector;
+        double minScore;
+        ScorerPtr scorer;
+    };
+
+    typedef boost::shared_ptr<MinScoreCollector> MinScoreCollectorPtr;
+}
+
+#endif // LUCENE_MIN_SCORE_COLLECTOR_H
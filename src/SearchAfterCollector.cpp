@@ -0,0 +1,92 @@
+/**
+ *  Collector of the top hits following a search cursor.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "SearchAfterCollector.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "Scorer.h"
+
+namespace Lucene
+{
+
+    SearchAfterCollector::SearchAfterCollector(int32_t numHits, double afterScore, int32_t afterDoc)
+        : numHits(numHits)
+        , after{ afterScore, afterDoc }
+        , totalHits(0)
+        , docBase(0)
+    {
+        heap.reserve(static_cast<size_t>(numHits));
+    }
+
+    SearchAfterCollector::~SearchAfterCollector() {
+    }
+
+    bool SearchAfterCollector::rankedBefore(const Hit& a, const Hit& b) {
+        return (a.score > b.score) || (a.score == b.score && a.doc < b.doc);
+    }
+
+    void SearchAfterCollector::setScorer(const ScorerPtr& scorer) {
+        this->scorer = scorer;
+    }
+
+    void SearchAfterCollector::collect(int32_t doc) {
+        const Hit hit{ scorer->score(), docBase + doc };
+        if (!rankedBefore(after, hit)) {
+            // the hit is on one of the previous pages
+            return;
+        }
+        ++totalHits;
+        if (static_cast<int32_t>(heap.size()) < numHits) {
+            heap.push_back(hit);
+            std::push_heap(heap.begin(), heap.end(), rankedBefore);
+        }
+        else if (numHits > 0 && rankedBefore(hit, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), rankedBefore);
+            heap.back() = hit;
+            std::push_heap(heap.begin(), heap.end(), rankedBefore);
+        }
+    }
+
+    void SearchAfterCollector::setNextReader(const IndexReaderPtr& reader, int32_t docBase) {
+        this->docBase = docBase;
+    }
+
+    bool SearchAfterCollector::acceptsDocsOutOfOrder() {
+        // ties are resolved by the document number, so the order of collection is not important
+        return true;
+    }
+
+    int32_t SearchAfterCollector::getTotalHits() {
+        return totalHits;
+    }
+
+    TopDocsPtr SearchAfterCollector::topDocs(int32_t start, int32_t howMany) {
+        std::vector<Hit> hits(heap);
+        std::sort(hits.begin(), hits.end(), rankedBefore);
+
+        const auto size = static_cast<int32_t>(hits.size());
+        start = std::min(std::max(start, 0), size);
+        howMany = std::min(std::max(howMany, 0), size - start);
+
+        auto scoreDocs = Collection<ScoreDocPtr>::newInstance(howMany);
+        for (int32_t i = 0; i < howMany; i++) {
+            const auto& hit = hits[start + i];
+            scoreDocs[i] = newLucene<ScoreDoc>(hit.doc, hit.score);
+        }
+        const double maxScore = hits.empty() ? std::numeric_limits<double>::quiet_NaN() : hits.front().score;
+        return newLucene<TopDocs>(totalHits, scoreDocs, maxScore);
+    }
+
+}
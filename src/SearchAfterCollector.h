@@ -0,0 +1,77 @@
+#ifndef LUCENE_SEARCH_AFTER_COLLECTOR_H
+#define LUCENE_SEARCH_AFTER_COLLECTOR_H
+
+/**
+ *  Collector of the top hits following a search cursor.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <vector>
+
+#include "LuceneHeaders.h"
+#include "Collector.h"
+
+namespace Lucene
+{
+    /// Collects the top hits ranked after the given hit (cursor).
+    ///
+    /// Hits are ranked by descending score and then by ascending document number,
+    /// the same way as {@link TopScoreDocCollector} does. Only hits that are ranked
+    /// after the cursor are put into the priority queue, so the queue never grows
+    /// beyond one page and the cost of a page does not depend on its number.
+    class SearchAfterCollector : public Collector {
+    public:
+        /// @param numHits Number of hits to collect.
+        /// @param afterScore Score of the last hit of the previous page.
+        /// @param afterDoc Document number of the last hit of the previous page.
+        SearchAfterCollector(int32_t numHits, double afterScore, int32_t afterDoc);
+
+        virtual ~SearchAfterCollector();
+
+        LUCENE_CLASS(SearchAfterCollector);
+
+    public:
+        virtual void setScorer(const ScorerPtr& scorer);
+        virtual void collect(int32_t doc);
+        virtual void setNextReader(const IndexReaderPtr& reader, int32_t docBase);
+        virtual bool acceptsDocsOutOfOrder();
+
+        /// Returns the number of hits ranked after the cursor.
+        int32_t getTotalHits();
+
+        /// Returns the collected hits in rank order.
+        /// @param start The offset of the first hit to return.
+        /// @param howMany The number of hits to return.
+        TopDocsPtr topDocs(int32_t start, int32_t howMany);
+
+    protected:
+        struct Hit
+        {
+            double score;
+            int32_t doc;
+        };
+
+        /// Returns true if hit a is ranked before hit b.
+        static bool rankedBefore(const Hit& a, const Hit& b);
+
+        int32_t numHits;
+        Hit after;
+        int32_t totalHits;
+        int32_t docBase;
+        ScorerPtr scorer;
+        // the last ranked hit is on the top of the heap
+        std::vector<Hit> heap;
+    };
+
+    typedef boost::shared_ptr<SearchAfterCollector> SearchAfterCollectorPtr;
+}
+
+#endif // LUCENE_SEARCH_AFTER_COLLECTOR_H
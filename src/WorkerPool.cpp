@@ -0,0 +1,87 @@
+/**
+ *  Process-wide pool of worker threads.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace LuceneUDR
+{
+
+    WorkerPool& WorkerPool::instance()
+    {
+        // The pool is never destroyed: joining the threads from a static destructor
+        // runs under the loader lock on Windows and can deadlock. Idle threads end with the process.
+        static WorkerPool* const pool = new WorkerPool(std::max(2u, std::thread::hardware_concurrency()));
+        return *pool;
+    }
+
+    WorkerPool::WorkerPool(size_t threadCount)
+    {
+        m_threads.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; i++) {
+            m_threads.emplace_back(&WorkerPool::workerLoop, this);
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopped = true;
+        }
+        m_condition.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    bool WorkerPool::runPendingTask(const Batch* batch)
+    {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = std::find_if(m_tasks.begin(), m_tasks.end(), [batch](const Task& queued) {
+                return queued.batch == batch;
+            });
+            if (it == m_tasks.end()) {
+                return false;
+            }
+            task = std::move(it->run);
+            m_tasks.erase(it);
+        }
+        task();
+        return true;
+    }
+
+    void WorkerPool::workerLoop()
+    {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stopped || !m_tasks.empty(); });
+                if (m_tasks.empty()) {
+                    // stopped and nothing left to do
+                    return;
+                }
+                task = std::move(m_tasks.front().run);
+                m_tasks.pop_front();
+            }
+            // packaged tasks keep their exceptions in the future
+            task();
+        }
+    }
+
+}
@@ -0,0 +1,142 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+/**
+ *  Process-wide pool of worker threads.
+ *
+ *  The original code was created by Simonov Denis
+ *  for the open source project "IBSurgeon Full Text Search UDR".
+ *
+ *  Copyright (c) 2022 Simonov Denis <sim-mail@list.ru>
+ *  and all contributors signed below.
+ *
+ *  All Rights Reserved.
+ *  Contributor(s): ______________________________________.
+**/
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace LuceneUDR
+{
+
+    /// <summary>
+    /// Pool of worker threads shared by all attachments.
+    ///
+    /// Tasks must not use Firebird interfaces, they only run Lucene searches.
+    /// Tasks are submitted and waited for through a batch. A thread waiting for a task result
+    /// executes the queued tasks of its own batch and then blocks until the result is ready,
+    /// so tasks may submit subtasks without exhausting the pool.
+    /// </summary>
+    class WorkerPool final
+    {
+    public:
+        /// <summary>
+        /// Tasks of one caller. Only the caller's thread may use the batch.
+        /// </summary>
+        class Batch final
+        {
+        public:
+            explicit Batch(WorkerPool& pool)
+                : m_pool(pool)
+            {
+            }
+
+            // non-copyable
+            Batch(const Batch& rhs) = delete;
+            Batch& operator=(const Batch& rhs) = delete;
+
+            /// <summary>
+            /// Puts the task into the queue of the pool.
+            /// </summary>
+            ///
+            /// <param name="task">Task to execute.</param>
+            ///
+            /// <returns>Future of the task result.</returns>
+            template <class F>
+            std::future<std::invoke_result_t<F>> submit(F&& task)
+            {
+                return m_pool.submit(this, std::forward<F>(task));
+            }
+
+            /// <summary>
+            /// Waits for the task result, executing the queued tasks of the batch meanwhile.
+            /// </summary>
+            ///
+            /// <param name="future">Future of a task of the batch.</param>
+            ///
+            /// <returns>Task result. The task exception is rethrown.</returns>
+            template <class R>
+            R wait(std::future<R>& future)
+            {
+                while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    if (!m_pool.runPendingTask(this)) {
+                        // the rest of the batch is executed by the workers
+                        future.wait();
+                    }
+                }
+                return future.get();
+            }
+
+        private:
+            WorkerPool& m_pool;
+        };
+
+        static WorkerPool& instance();
+
+        explicit WorkerPool(size_t threadCount);
+
+        // non-copyable
+        WorkerPool(const WorkerPool& rhs) = delete;
+        WorkerPool& operator=(const WorkerPool& rhs) = delete;
+
+        ~WorkerPool();
+
+        size_t size() const
+        {
+            return m_threads.size();
+        }
+
+    private:
+        struct Task
+        {
+            const Batch* batch;
+            std::function<void()> run;
+        };
+
+        template <class F>
+        std::future<std::invoke_result_t<F>> submit(const Batch* batch, F&& task)
+        {
+            using R = std::invoke_result_t<F>;
+            auto packagedTask = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+            auto future = packagedTask->get_future();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_tasks.push_back({ batch, [packagedTask]() { (*packagedTask)(); } });
+            }
+            m_condition.notify_one();
+            return future;
+        }
+
+        bool runPendingTask(const Batch* batch);
+        void workerLoop();
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<Task> m_tasks;
+        std::vector<std::thread> m_threads;
+        bool m_stopped = false;
+    };
+
+}
+
+#endif // WORKER_POOL_H